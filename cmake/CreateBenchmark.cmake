@@ -0,0 +1,40 @@
+# Macro which contains all bits and pieces to create the benchmark target.
+# The 'benchmark' target runs the game state of a set of reference savegames
+# as fast as possible, and reports the speed and final checksum of each.
+#
+# By default the savegames of the regression tests are used; set
+# BENCHMARK_SAVES to a list of savegames to benchmark those instead.
+#
+# create_benchmark()
+#
+macro(create_benchmark)
+    set(BENCHMARK_SAVES "" CACHE STRING "List of savegames used by the benchmark target (default: regression savegames)")
+    set(BENCHMARK_TICKS "10000" CACHE STRING "Number of ticks each savegame is run for by the benchmark target")
+
+    if(BENCHMARK_SAVES)
+        set(BENCHMARK_SAVE_FILES ${BENCHMARK_SAVES})
+    else()
+        file(GLOB BENCHMARK_SAVE_FILES ${CMAKE_SOURCE_DIR}/regression/*/test.sav)
+    endif()
+
+    unset(BENCHMARK_COMMANDS)
+    foreach(BENCHMARK_SAVE IN LISTS BENCHMARK_SAVE_FILES)
+        list(APPEND BENCHMARK_COMMANDS
+                COMMAND ${CMAKE_COMMAND}
+                        -DOPENTTD_EXECUTABLE=$<TARGET_FILE:openttd>
+                        -DEDITBIN_EXECUTABLE=${EDITBIN_EXECUTABLE}
+                        -DBENCHMARK_SAVE=${BENCHMARK_SAVE}
+                        -DBENCHMARK_TICKS=${BENCHMARK_TICKS}
+                        -P "${CMAKE_SOURCE_DIR}/cmake/scripts/Benchmark.cmake"
+        )
+    endforeach()
+
+    # The regression files are needed for the configuration and the AIs
+    # used by the regression savegames.
+    add_custom_target(benchmark
+            ${BENCHMARK_COMMANDS}
+            DEPENDS openttd regression_files
+            WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+            COMMENT "Running benchmark"
+    )
+endmacro()
@@ -1,5 +1,5 @@
 # Autodetect if SSE4.1 can be used. If so, the assumption is, so can the other
-# SSE version (SSE 2.0, SSSE 3.0).
+# SSE version (SSE 2.0, SSSE 3.0). AVX2 is detected separately.
 
 include(CheckCXXSourceCompiles)
 set(CMAKE_REQUIRED_FLAGS "")
@@ -15,3 +15,13 @@ check_cxx_source_compiles("
     int main() { return 0; }"
     SSE_FOUND
 )
+
+if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU" OR CMAKE_CXX_COMPILER_ID STREQUAL "Clang" OR CMAKE_CXX_COMPILER_ID STREQUAL "AppleClang")
+    set(CMAKE_REQUIRED_FLAGS "-mavx2")
+endif()
+
+check_cxx_source_compiles("
+    #include <immintrin.h>
+    int main() { __m256i a = _mm256_setzero_si256(); a = _mm256_add_epi16(a, a); return _mm256_testz_si256(a, a) ? 0 : 1; }"
+    AVX2_FOUND
+)
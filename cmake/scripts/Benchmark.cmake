@@ -0,0 +1,47 @@
+cmake_minimum_required(VERSION 3.5)
+
+#
+# Runs the benchmark over a single savegame
+#
+
+if(NOT BENCHMARK_SAVE)
+    message(FATAL_ERROR "Script needs BENCHMARK_SAVE defined (tip: use -DBENCHMARK_SAVE=..)")
+endif()
+if(NOT BENCHMARK_TICKS)
+    message(FATAL_ERROR "Script needs BENCHMARK_TICKS defined (tip: use -DBENCHMARK_TICKS=..)")
+endif()
+if(NOT OPENTTD_EXECUTABLE)
+    message(FATAL_ERROR "Script needs OPENTTD_EXECUTABLE defined (tip: use -DOPENTTD_EXECUTABLE=..)")
+endif()
+
+if(NOT EXISTS ${BENCHMARK_SAVE})
+    message(FATAL_ERROR "Benchmark savegame ${BENCHMARK_SAVE} does not exist")
+endif()
+
+# If editbin is given, copy the executable to a new folder, and change the
+# subsystem to console, so the results end up on the console.
+if(EDITBIN_EXECUTABLE)
+    execute_process(COMMAND ${CMAKE_COMMAND} -E copy ${OPENTTD_EXECUTABLE} benchmark.exe)
+    set(OPENTTD_EXECUTABLE "benchmark.exe")
+
+    execute_process(COMMAND ${EDITBIN_EXECUTABLE} /nologo /subsystem:console ${OPENTTD_EXECUTABLE})
+endif()
+
+# Run the benchmark; the regression configuration is used so all runs start
+# from the same settings.
+execute_process(COMMAND ${OPENTTD_EXECUTABLE}
+                        -x
+                        -c regression/regression.cfg
+                        -g ${BENCHMARK_SAVE}
+                        -B ${BENCHMARK_TICKS}
+                RESULT_VARIABLE BENCHMARK_RESULT
+                OUTPUT_VARIABLE BENCHMARK_OUTPUT
+                ERROR_VARIABLE BENCHMARK_ERROR
+                OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+
+if(NOT BENCHMARK_RESULT EQUAL 0)
+    message(FATAL_ERROR "Benchmark of ${BENCHMARK_SAVE} failed: ${BENCHMARK_ERROR}")
+endif()
+
+message("Benchmark of ${BENCHMARK_SAVE}:\n${BENCHMARK_OUTPUT}\n")
@@ -1373,6 +1373,7 @@ static void MaybeCrashAirplane(Aircraft *v)
 		st->goods[i].rating = 1;
 		st->goods[i].cargo.Truncate();
 	}
+	st->rated_cargoes = ALL_CARGOTYPES;
 
 	CrashAirplane(v);
 }
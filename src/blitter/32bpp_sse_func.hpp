@@ -98,6 +98,50 @@ static inline __m128i DarkenTwoPixels(__m128i src, __m128i dst, const __m128i &d
 	return _mm_packus_epi16(dstAB, dstAB);
 }
 
+#if (SSE_VERSION >= 5)
+/** Alpha blend 4 pixels, see AlphaBlendTwoPixels(). */
+static inline __m128i AlphaBlendFourPixels(__m128i src, __m128i dst, const __m256i &distribution_mask, const __m256i &pack_mask)
+{
+	__m256i srcAD = _mm256_cvtepu8_epi16(src);                            // VPMOVZXBW, expand each uint8 into uint16
+	__m256i dstAD = _mm256_cvtepu8_epi16(dst);
+
+	__m256i alphaAD = _mm256_cmpgt_epi16(srcAD, _mm256_setzero_si256()); // VPCMPGTW, if (alpha > 0) a++;
+	alphaAD = _mm256_srli_epi16(alphaAD, 15);
+	alphaAD = _mm256_add_epi16(alphaAD, srcAD);
+	alphaAD = _mm256_shuffle_epi8(alphaAD, distribution_mask);
+
+	srcAD = _mm256_sub_epi16(srcAD, dstAD);     // VPSUBW,    (r - Cr)
+	srcAD = _mm256_mullo_epi16(srcAD, alphaAD); // VPMULLW, a*(r - Cr)
+	srcAD = _mm256_srli_epi16(srcAD, 8);        // VPSRLW,  a*(r - Cr)/256
+	srcAD = _mm256_add_epi16(srcAD, dstAD);     // VPADDW,  a*(r - Cr)/256 + Cr
+	srcAD = _mm256_shuffle_epi8(srcAD, pack_mask);
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(srcAD, 0x08)); // VPERMQ, join the packed pixels of both lanes
+}
+
+/** Darken 4 pixels, see DarkenTwoPixels(). */
+static inline __m128i DarkenFourPixels(__m128i src, __m128i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i srcAD = _mm256_cvtepu8_epi16(src);
+	__m256i dstAD = _mm256_cvtepu8_epi16(dst);
+	__m256i alphaAD = _mm256_shuffle_epi8(srcAD, distribution_mask);
+	alphaAD = _mm256_srli_epi16(alphaAD, 2); // Reduce to 64 levels of shades so the max value fits in 16 bits.
+	__m256i nom = _mm256_sub_epi16(tr_nom_base, alphaAD);
+	dstAD = _mm256_mullo_epi16(dstAD, nom);
+	dstAD = _mm256_srli_epi16(dstAD, 8);
+	dstAD = _mm256_packus_epi16(dstAD, dstAD);
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(dstAD, 0x08));
+}
+
+/** Copy the 8 pixels of \a src that are not fully transparent to \a dst. */
+static inline void CopyEightOpaquePixels(const Colour *src, Colour *dst, const __m256i &alpha_mask)
+{
+	__m256i srcAH = _mm256_loadu_si256((const __m256i*) src);
+	__m256i dstAH = _mm256_loadu_si256((const __m256i*) dst);
+	__m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(srcAH, alpha_mask), _mm256_setzero_si256());
+	_mm256_storeu_si256((__m256i*) dst, _mm256_blendv_epi8(srcAH, dstAH, transparent)); // VPBLENDVB, keep dst where alpha == 0
+}
+#endif
+
 IGNORE_UNINITIALIZED_WARNING_START
 static Colour ReallyAdjustBrightness(Colour colour, uint8 brightness)
 {
@@ -198,6 +242,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const byte * const remap = bp->remap;
@@ -232,6 +278,12 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i a_cm_x2        = _mm256_broadcastsi128_si256(a_cm);
+	const __m256i pack_low_cm_x2 = _mm256_broadcastsi128_si256(pack_low_cm);
+	const __m256i tr_nom_base_x2 = _mm256_broadcastsi128_si256(tr_nom_base);
+	const __m256i alpha_mask     = _mm256_set1_epi32(0xFF000000);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -254,7 +306,16 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 		switch (mode) {
 			default:
 				if (!translucent) {
+#if (SSE_VERSION >= 5)
+					for (uint x = (uint) effective_width / 8; x > 0; x--) {
+						CopyEightOpaquePixels(src, dst, alpha_mask);
+						src += 8;
+						dst += 8;
+					}
+					for (uint x = (uint) effective_width & 7; x > 0; x--) {
+#else
 					for (uint x = (uint) effective_width; x > 0; x--) {
+#endif
 						if (src->a) *dst = *src;
 						src++;
 						dst++;
@@ -262,7 +323,19 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) effective_width / 4; x > 0; x--) {
+					__m128i srcABCD = _mm_loadu_si128((const __m128i*) src);
+					__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+					_mm_storeu_si128((__m128i*) dst, AlphaBlendFourPixels(srcABCD, dstABCD, a_cm_x2, pack_low_cm_x2));
+					src += 4;
+					dst += 4;
+				}
+
+				for (uint x = ((uint) effective_width & 3) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2));
@@ -361,7 +434,19 @@ bmcr_alpha_blend_single:
 
 			case BM_TRANSPARENT:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) bp->width / 4; x > 0; x--) {
+					__m128i srcABCD = _mm_loadu_si128((const __m128i*) src);
+					__m128i dstABCD = _mm_loadu_si128((__m128i*) dst);
+					_mm_storeu_si128((__m128i *) dst, DarkenFourPixels(srcABCD, dstABCD, a_cm_x2, tr_nom_base_x2));
+					src += 4;
+					dst += 4;
+				}
+
+				for (uint x = ((uint) bp->width & 3) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) bp->width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
@@ -426,6 +511,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
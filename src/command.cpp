@@ -265,7 +265,7 @@ static const Command _command_proc_table[] = {
 
 	DEF_CMD(CmdChangeServiceInt,                               0, CMDT_VEHICLE_MANAGEMENT    ), // CMD_CHANGE_SERVICE_INT
 
-	DEF_CMD(CmdBuildIndustry,                          CMD_DEITY, CMDT_LANDSCAPE_CONSTRUCTION), // CMD_BUILD_INDUSTRY
+	DEF_CMD(CmdBuildIndustry,               CMD_DEITY | CMD_PLAN, CMDT_LANDSCAPE_CONSTRUCTION), // CMD_BUILD_INDUSTRY
 	DEF_CMD(CmdIndustryCtrl,            CMD_STR_CTRL | CMD_DEITY, CMDT_OTHER_MANAGEMENT      ), // CMD_INDUSTRY_CTRL
 
 	DEF_CMD(CmdSetCompanyManagerFace,                          0, CMDT_OTHER_MANAGEMENT      ), // CMD_SET_COMPANY_MANAGER_FACE
@@ -439,6 +439,57 @@ bool IsCommandAllowedWhilePaused(uint32 cmd)
 
 static int _docommand_recursive = 0;
 
+static bool _command_plan_allowed = false;         ///< Whether the toplevel command being run may make a plan.
+static std::unique_ptr<CommandPlan> _command_plan; ///< The plan made by the test run of the toplevel command being run.
+
+/**
+ * Start running a toplevel command, forgetting the plan of any previous command.
+ * @param cmd The command that is going to be run.
+ */
+static void ResetCommandPlan(uint32 cmd)
+{
+	_command_plan_allowed = (GetCommandFlags(cmd) & CMD_PLAN) != 0;
+	_command_plan.reset();
+}
+
+/**
+ * Store the plan the test run of a command made, for its execution run.
+ * When the plan is not going to be used the plan is just freed, so commands can
+ * always call this when they have made their checks.
+ * With desync debugging at level 2 or higher the execution run does not get the
+ * plan of the test run but runs all checks again and calls this too; the plans
+ * of both runs are then compared to verify that the plan gives the same result.
+ * @param plan The plan; ownership is transferred.
+ * @param flags The flags the command is run with.
+ */
+void SetCommandPlan(CommandPlan *plan, DoCommandFlag flags)
+{
+	std::unique_ptr<CommandPlan> new_plan(plan);
+
+	/* Only toplevel commands are run in the test and execution order a plan relies on. */
+	if (!_command_plan_allowed || _docommand_recursive != 1) return;
+
+	if (!(flags & DC_EXEC)) {
+		_command_plan = std::move(new_plan);
+	} else if (_command_plan != nullptr && !_command_plan->Equals(*new_plan)) {
+		DEBUG(desync, 0, "command plan mismatch: date{%08x; %02x}; company %02x", _date, _date_fract, (int)_current_company);
+	}
+}
+
+/**
+ * Get the plan the test run of the command made, for the execution run to commit.
+ * @return The plan, or \c nullptr if the command has to do all checks itself.
+ */
+const CommandPlan *GetCommandPlan()
+{
+	if (!_command_plan_allowed || _docommand_recursive != 1) return nullptr;
+
+	/* Let the execution run check everything itself, and compare plans in SetCommandPlan. */
+	if (_debug_desync_level >= 2) return nullptr;
+
+	return _command_plan.get();
+}
+
 /**
  * Shorthand for calling the long DoCommand with a container.
  *
@@ -477,6 +528,8 @@ CommandCost DoCommand(TileIndex tile, uint32 p1, uint32 p2, DoCommandFlag flags,
 
 	_docommand_recursive++;
 
+	if (_docommand_recursive == 1) ResetCommandPlan(cmd);
+
 	/* only execute the test call if it's toplevel, or we're not execing. */
 	if (_docommand_recursive == 1 || !(flags & DC_EXEC) ) {
 		if (_docommand_recursive == 1) _cleared_object_areas.clear();
@@ -676,6 +729,7 @@ CommandCost DoCommandPInternal(TileIndex tile, uint32 p1, uint32 p2, uint32 cmd,
 	bool test_and_exec_can_differ = (cmd_flags & CMD_NO_TEST) != 0;
 
 	/* Test the command. */
+	ResetCommandPlan(cmd);
 	_cleared_object_areas.clear();
 	SetTownRatingTestMode(true);
 	BasePersistentStorageArray::SwitchMode(PSM_ENTER_TESTMODE);
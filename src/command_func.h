@@ -50,6 +50,9 @@ const char *GetCommandName(uint32 cmd);
 Money GetAvailableMoneyForCommand();
 bool IsCommandAllowedWhilePaused(uint32 cmd);
 
+void SetCommandPlan(CommandPlan *plan, DoCommandFlag flags);
+const CommandPlan *GetCommandPlan();
+
 /**
  * Extracts the DC flags needed for DoCommand from the flags returned by GetCommandFlags
  * @param cmd_flags Flags from GetCommandFlags
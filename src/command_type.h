@@ -399,6 +399,7 @@ enum CommandFlags {
 	CMD_DEITY     = 0x100, ///< the command may be executed by COMPANY_DEITY
 	CMD_STR_CTRL  = 0x200, ///< the command's string may contain control strings
 	CMD_NO_EST    = 0x400, ///< the command is never estimated.
+	CMD_PLAN      = 0x800, ///< the command's test run may make a plan for its execution run, see #CommandPlan.
 };
 DECLARE_ENUM_AS_BIT_SET(CommandFlags)
 
@@ -473,6 +474,26 @@ struct Command {
  */
 typedef void CommandCallback(const CommandCost &result, TileIndex tile, uint32 p1, uint32 p2, uint32 cmd);
 
+/**
+ * Result of the checks of the test run of a command, so its execution run can
+ * commit the work directly instead of checking everything again.
+ * Only commands with #CMD_PLAN make plans; the plan is only handed to the
+ * execution run directly following the test run of the same toplevel command,
+ * so nothing can have changed in between.
+ * @see SetCommandPlan
+ * @see GetCommandPlan
+ */
+struct CommandPlan {
+	virtual ~CommandPlan() {}
+
+	/**
+	 * Check whether this plan is the same as another plan of the same command.
+	 * @param other The other plan.
+	 * @return True iff both plans do the same.
+	 */
+	virtual bool Equals(const CommandPlan &other) const = 0;
+};
+
 /**
  * Structure for buffering the build command when selecting a station to join.
  */
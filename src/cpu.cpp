@@ -101,7 +101,12 @@ uint64 ottd_rdtsc() {return 0;}
 #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 void ottd_cpuid(int info[4], int type)
 {
-	__cpuid(info, type);
+	__cpuidex(info, type, 0);
+}
+
+static uint64 ottd_xgetbv()
+{
+	return _xgetbv(0);
 }
 #elif defined(__x86_64__) || defined(__i386)
 void ottd_cpuid(int info[4], int type)
@@ -121,21 +126,34 @@ void ottd_cpuid(int info[4], int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #else
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #endif /* i386 PIC */
 }
+
+static uint64 ottd_xgetbv()
+{
+	uint32 high, low;
+	/* XGETBV, written as bytes as older assemblers do not know it. */
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a" (low), "=d" (high) : "c" (0));
+	return ((uint64)high << 32) | low;
+}
 #else
 void ottd_cpuid(int info[4], int type)
 {
 	info[0] = info[1] = info[2] = info[3] = 0;
 }
+
+static uint64 ottd_xgetbv()
+{
+	return 0;
+}
 #endif
 
 bool HasCPUIDFlag(uint type, uint index, uint bit)
@@ -148,3 +166,12 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	ottd_cpuid(cpu_info, type);
 	return HasBit(cpu_info[index], bit);
 }
+
+bool HasCPUAVX2Support()
+{
+	/* The OS has to save the AVX registers (XMM and YMM state) on context switches. */
+	if (!HasCPUIDFlag(1, 2, 27) || !HasCPUIDFlag(1, 2, 28)) return false;
+	if ((ottd_xgetbv() & 0x6) != 0x6) return false;
+
+	return HasCPUIDFlag(7, 1, 5);
+}
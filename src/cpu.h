@@ -32,4 +32,10 @@ void ottd_cpuid(int info[4], int type);
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether the current CPU supports AVX2 and the OS saves the AVX registers.
+ * @return True iff AVX2 instructions can be used.
+ */
+bool HasCPUAVX2Support();
+
 #endif /* CPU_H */
@@ -48,6 +48,8 @@
 #include "goal_base.h"
 #include "story_base.h"
 #include "linkgraph/refresh.h"
+#include "pathfinder/yapf/yapf_cache.h"
+#include "signal_func.h"
 
 #include "table/strings.h"
 #include "table/pricebase.h"
@@ -475,6 +477,12 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 			ChangeTileOwner(tile, old_owner, new_owner);
 		} while (++tile != MapSize());
 
+		/* Road vehicles may not enter depots of other companies. */
+		YapfNotifyRoadCostChange(INVALID_TILE);
+
+		/* Signal blocks end at tiles of other companies. */
+		InvalidateSignalBlockCache();
+
 		if (new_owner != INVALID_OWNER) {
 			/* Update all signals because there can be new segment that was owned by two companies
 			 * and signals were not propagated
@@ -1696,6 +1704,7 @@ static void LoadUnloadVehicle(Vehicle *front)
 					 * first unload to prevent the cargo from quickly decaying after the initial drop. */
 					ge->time_since_pickup = 0;
 					SetBit(ge->status, GoodsEntry::GES_RATING);
+					SetBit(st->rated_cargoes, v->cargo_type);
 				}
 			}
 
@@ -60,13 +60,18 @@ namespace {
 		/** Start time for current accumulation cycle */
 		TimingMeasurement acc_timestamp;
 
+		/** Sum of all durations since the totals were last reset */
+		TimingMeasurement total_duration;
+		/** Number of cycles making up \c total_duration */
+		uint64 total_count;
+
 		/**
 		 * Initialize a data element with an expected collection rate
 		 * @param expected_rate
 		 * Expected number of cycles per second of the performance element. Use 1 if unknown or not relevant.
 		 * The rate is used for highlighting slow-running elements in the GUI.
 		 */
-		explicit PerformanceData(double expected_rate) : expected_rate(expected_rate), next_index(0), prev_index(0), num_valid(0) { }
+		explicit PerformanceData(double expected_rate) : expected_rate(expected_rate), next_index(0), prev_index(0), num_valid(0), total_duration(0), total_count(0) { }
 
 		/** Collect a complete measurement, given start and ending times for a processing block */
 		void Add(TimingMeasurement start_time, TimingMeasurement end_time)
@@ -77,6 +82,9 @@ namespace {
 			this->next_index += 1;
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
 			this->num_valid = std::min(NUM_FRAMERATE_POINTS, this->num_valid + 1);
+
+			this->total_duration += end_time - start_time;
+			this->total_count++;
 		}
 
 		/** Begin an accumulation of multiple measurements into a single value, from a given start time */
@@ -89,6 +97,9 @@ namespace {
 			if (this->next_index >= NUM_FRAMERATE_POINTS) this->next_index = 0;
 			this->num_valid = std::min(NUM_FRAMERATE_POINTS, this->num_valid + 1);
 
+			this->total_duration += this->acc_duration;
+			this->total_count++;
+
 			this->acc_duration = 0;
 			this->acc_timestamp = start_time;
 		}
@@ -1016,6 +1027,24 @@ void ShowFrametimeGraphWindow(PerformanceElement elem)
 	AllocateWindowDescFront<FrametimeGraphWindow>(&_frametime_graph_window_desc, elem, true);
 }
 
+/** Names of the performance elements for text output, the AI elements are named separately. */
+static const char *MEASUREMENT_NAMES[PFE_AI0] = {
+	"Game loop",
+	"  GL station ticks",
+	"  GL train ticks",
+	"  GL road vehicle ticks",
+	"  GL ship ticks",
+	"  GL aircraft ticks",
+	"  GL landscape ticks",
+	"  GL link graph delays",
+	"Drawing",
+	"  Viewport drawing",
+	"Video output",
+	"Sound mixing",
+	"AI/GS scripts total",
+	"Game script",
+};
+
 /** Print performance statistics to game console */
 void ConPrintFramerate()
 {
@@ -1025,22 +1054,6 @@ void ConPrintFramerate()
 
 	IConsolePrintF(TC_SILVER, "Based on num. data points: %d %d %d", count1, count2, count3);
 
-	static const char *MEASUREMENT_NAMES[PFE_MAX] = {
-		"Game loop",
-		"  GL station ticks",
-		"  GL train ticks",
-		"  GL road vehicle ticks",
-		"  GL ship ticks",
-		"  GL aircraft ticks",
-		"  GL landscape ticks",
-		"  GL link graph delays",
-		"Drawing",
-		"  Viewport drawing",
-		"Video output",
-		"Sound mixing",
-		"AI/GS scripts total",
-		"Game script",
-	};
 	char ai_name_buf[128];
 
 	static const PerformanceElement rate_elements[] = { PFE_GAMELOOP, PFE_DRAWING, PFE_VIDEO };
@@ -1079,3 +1092,41 @@ void ConPrintFramerate()
 		IConsoleWarning("No performance measurements have been taken yet");
 	}
 }
+
+/** Reset the performance totals, so a new benchmark run can be measured. */
+void ResetPerformanceTotals()
+{
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		_pf_data[e].total_duration = 0;
+		_pf_data[e].total_count = 0;
+	}
+}
+
+/**
+ * Print the performance totals since the last reset to standard output.
+ * @param ticks Number of game ticks the totals were collected over.
+ */
+void PrintPerformanceTotals(uint ticks)
+{
+	const double gameloop_ms = (double)_pf_data[PFE_GAMELOOP].total_duration * 1000 / TIMESTAMP_PRECISION;
+
+	printf("%-32s %12s %12s %8s\n", "Element", "total ms", "ms/tick", "share");
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		auto &pf = _pf_data[e];
+		if (pf.total_count == 0) continue;
+
+		char name[128];
+		if (e < PFE_AI0) {
+			strecpy(name, MEASUREMENT_NAMES[e], lastof(name));
+		} else {
+			seprintf(name, lastof(name), "AI %d %s", e - PFE_AI0 + 1, GetAIName(e - PFE_AI0));
+		}
+
+		double total_ms = (double)pf.total_duration * 1000 / TIMESTAMP_PRECISION;
+		printf("%-32s %12.2f %12.4f %7.1f%%\n",
+			name,
+			total_ms,
+			ticks == 0 ? 0.0 : total_ms / ticks,
+			gameloop_ms == 0 ? 0.0 : total_ms * 100 / gameloop_ms);
+	}
+}
@@ -121,5 +121,7 @@ public:
 };
 
 void ShowFramerateWindow();
+void ResetPerformanceTotals();
+void PrintPerformanceTotals(uint ticks);
 
 #endif /* FRAMERATE_TYPE_H */
@@ -19,6 +19,7 @@
 #include "network/network_func.h"
 #include "window_func.h"
 #include "newgrf_debug.h"
+#include "smallmap_gui.h"
 #include "thread.h"
 
 #include "table/palettes.h"
@@ -1642,6 +1643,7 @@ void AddDirtyBlock(int left, int top, int right, int bottom)
  */
 void MarkWholeScreenDirty()
 {
+	InvalidateSmallMapColourCache();
 	AddDirtyBlock(0, 0, _screen.width, _screen.height);
 }
 
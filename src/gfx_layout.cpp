@@ -33,6 +33,12 @@
 /** Cache of ParagraphLayout lines. */
 Layouter::LineCache *Layouter::linecache;
 
+/** Order in which the lines of the cache were last used. */
+Layouter::LineCacheOrder *Layouter::linecache_order;
+
+/** Maximum number of lines in the cache after #Layouter::ReduceLineCache. */
+static const size_t MAX_LINE_CACHE_SIZE = 4096;
+
 /** Cache of Font instances. */
 Layouter::FontColourMap Layouter::fonts[FS_END];
 
@@ -657,6 +663,36 @@ static inline void GetLayouter(Layouter::LineCacheItem &line, const char *&str,
 	line.state_after = state;
 }
 
+#if defined(WITH_ICU_LX) || defined(WITH_UNISCRIBE) || defined(WITH_COCOA)
+/**
+ * Check whether a line only consists of characters that need no shaping, such
+ * as numbers, currency symbols and punctuation. Such lines, which are common in
+ * e.g. finances and vehicle lists, are laid out by the fallback layouter as the
+ * system layouter would not do anything different for them.
+ * @param str Start of the line.
+ * @param end End of the line.
+ * @return True iff the line needs no shaping.
+ */
+static bool IsUnshapedLine(const char *str, const char *end)
+{
+	/* Right-to-left paragraphs can reorder numbers separated by spaces. */
+	if (_current_text_dir != TD_LTR) return false;
+
+	while (str < end) {
+		WChar c;
+		str += Utf8Decode(&c, str);
+		if (c >= ' ' && c <= '@') continue; // Space, digits and ASCII punctuation.
+		if (c >= 0xA0 && c <= 0xBF) continue; // No-break space and Latin-1 symbols, like the pound sign.
+		if (c == 0x20AC) continue; // Euro sign.
+		if (c >= SCC_BLUE && c <= SCC_BLACK) continue;
+		if (c == SCC_PUSH_COLOUR || c == SCC_POP_COLOUR) continue;
+		if (c >= SCC_FIRST_FONT && c <= SCC_LAST_FONT) continue;
+		return false;
+	}
+	return true;
+}
+#endif
+
 /**
  * Create a new layouter.
  * @param str      The string to create the layout for.
@@ -689,11 +725,12 @@ Layouter::Layouter(const char *str, int maxw, TextColour colour, FontSize fontsi
 			FontState old_state = state;
 #if defined(WITH_ICU_LX) || defined(WITH_UNISCRIBE) || defined(WITH_COCOA)
 			const char *old_str = str;
+			bool unshaped = IsUnshapedLine(str, lineend);
 #endif
 
 #ifdef WITH_ICU_LX
-			GetLayouter<ICUParagraphLayoutFactory>(line, str, state);
-			if (line.layout == nullptr) {
+			if (!unshaped) GetLayouter<ICUParagraphLayoutFactory>(line, str, state);
+			if (line.layout == nullptr && !unshaped) {
 				static bool warned = false;
 				if (!warned) {
 					DEBUG(misc, 0, "ICU layouter bailed on the font. Falling back to the fallback layouter");
@@ -706,7 +743,7 @@ Layouter::Layouter(const char *str, int maxw, TextColour colour, FontSize fontsi
 #endif
 
 #ifdef WITH_UNISCRIBE
-			if (line.layout == nullptr) {
+			if (line.layout == nullptr && !unshaped) {
 				GetLayouter<UniscribeParagraphLayoutFactory>(line, str, state);
 				if (line.layout == nullptr) {
 					state = old_state;
@@ -716,7 +753,7 @@ Layouter::Layouter(const char *str, int maxw, TextColour colour, FontSize fontsi
 #endif
 
 #ifdef WITH_COCOA
-			if (line.layout == nullptr) {
+			if (line.layout == nullptr && !unshaped) {
 				GetLayouter<CoreTextParagraphLayoutFactory>(line, str, state);
 				if (line.layout == nullptr) {
 					state = old_state;
@@ -874,7 +911,7 @@ void Layouter::ResetFontCache(FontSize size)
 }
 
 /**
- * Get reference to cache item.
+ * Get reference to cache item, and mark it as most recently used.
  * If the item does not exist yet, it is default constructed.
  * @param str Source string of the line (including colour and font size codes).
  * @param len Length of \a str in bytes (no termination).
@@ -886,12 +923,22 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(const char *str, siz
 	if (linecache == nullptr) {
 		/* Create linecache on first access to avoid trouble with initialisation order of static variables. */
 		linecache = new LineCache();
+		linecache_order = new LineCacheOrder();
 	}
 
 	LineCacheKey key;
 	key.state_before = state;
 	key.str.assign(str, len);
-	return (*linecache)[key];
+
+	auto result = linecache->try_emplace(std::move(key));
+	LineCacheItem &item = result.first->second;
+	if (result.second) {
+		linecache_order->push_front(&result.first->first);
+	} else {
+		linecache_order->splice(linecache_order->begin(), *linecache_order, item.order);
+	}
+	item.order = linecache_order->begin();
+	return item;
 }
 
 /**
@@ -900,15 +947,22 @@ Layouter::LineCacheItem &Layouter::GetCachedParagraphLayout(const char *str, siz
 void Layouter::ResetLineCache()
 {
 	if (linecache != nullptr) linecache->clear();
+	if (linecache_order != nullptr) linecache_order->clear();
 }
 
 /**
  * Reduce the size of linecache if necessary to prevent infinite growth.
+ * The least recently used lines are removed, so the lines of the open
+ * windows stay in the cache.
+ * @note Lines must not be removed while a #Layouter refers to them, so this is only called outside of drawing.
  */
 void Layouter::ReduceLineCache()
 {
-	if (linecache != nullptr) {
-		/* TODO LRU cache would be fancy, but not exactly necessary */
-		if (linecache->size() > 4096) ResetLineCache();
+	if (linecache == nullptr) return;
+
+	while (linecache->size() > MAX_LINE_CACHE_SIZE) {
+		LineCache::iterator oldest = linecache->find(*linecache_order->back());
+		linecache_order->pop_back();
+		linecache->erase(oldest);
 	}
 }
@@ -14,9 +14,10 @@
 #include "gfx_func.h"
 #include "core/smallmap_type.hpp"
 
-#include <map>
+#include <list>
 #include <string>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 #ifdef WITH_ICU_LX
@@ -156,15 +157,26 @@ class Layouter : public std::vector<std::unique_ptr<const ParagraphLayouter::Lin
 		FontState state_before;  ///< Font state at the beginning of the line.
 		std::string str;         ///< Source string of the line (including colour and font size codes).
 
-		/** Comparison operator for std::map */
-		bool operator<(const LineCacheKey &other) const
+		/** Comparison operator for std::unordered_map */
+		bool operator==(const LineCacheKey &other) const
 		{
-			if (this->state_before.fontsize != other.state_before.fontsize) return this->state_before.fontsize < other.state_before.fontsize;
-			if (this->state_before.cur_colour != other.state_before.cur_colour) return this->state_before.cur_colour < other.state_before.cur_colour;
-			if (this->state_before.colour_stack != other.state_before.colour_stack) return this->state_before.colour_stack < other.state_before.colour_stack;
-			return this->str < other.str;
+			return this->state_before.fontsize == other.state_before.fontsize &&
+					this->state_before.cur_colour == other.state_before.cur_colour &&
+					this->state_before.colour_stack == other.state_before.colour_stack &&
+					this->str == other.str;
 		}
 	};
+
+	/** Hash function of the keys into the linecache */
+	struct LineCacheHash {
+		size_t operator()(const LineCacheKey &key) const
+		{
+			size_t state = (size_t)key.state_before.fontsize << 16 | (size_t)key.state_before.cur_colour << 4 | (key.state_before.colour_stack.size() & 0xF);
+			return std::hash<std::string>()(key.str) ^ (state * 0x9E3779B1U);
+		}
+	};
+
+	typedef std::list<const LineCacheKey *> LineCacheOrder; ///< Keys of the linecache, from most to least recently used.
 public:
 	/** Item in the linecache */
 	struct LineCacheItem {
@@ -175,12 +187,15 @@ public:
 		FontState state_after;     ///< Font state after the line.
 		ParagraphLayouter *layout; ///< Layout of the line.
 
+		LineCacheOrder::iterator order; ///< Position of the line in #Layouter::linecache_order.
+
 		LineCacheItem() : buffer(nullptr), layout(nullptr) {}
 		~LineCacheItem() { delete layout; free(buffer); }
 	};
 private:
-	typedef std::map<LineCacheKey, LineCacheItem> LineCache;
+	typedef std::unordered_map<LineCacheKey, LineCacheItem, LineCacheHash> LineCache;
 	static LineCache *linecache;
+	static LineCacheOrder *linecache_order;
 
 	static LineCacheItem &GetCachedParagraphLayout(const char *str, size_t len, const FontState &state);
 
@@ -1908,31 +1908,27 @@ static void DoCreateNewIndustry(Industry *i, TileIndex tile, IndustryType type,
 }
 
 /**
- * Helper function for Build/Fund an industry
+ * Check whether an industry can be built/funded.
  * @param tile tile where industry is built
  * @param type of industry to build
- * @param flags of operations to conduct
  * @param indspec pointer to industry specifications
  * @param layout_index the index of the itsepc to build/fund
  * @param random_var8f random seed (possibly) used by industries
  * @param random_initial_bits The random bits the industry is going to have after construction.
  * @param founder Founder of the industry
  * @param creation_type The circumstances the industry is created under.
- * @param[out] ip Pointer to store newly created industry.
+ * @param[out] tp Pointer to store the town the industry is going to belong to.
+ * @param[out] custom_shape_check Pointer to store whether the industry tiles are checked by a NewGRF callback.
  * @return Succeeded or failed command.
- *
- * @post \c *ip contains the newly created industry if all checks are successful and the \a flags request actual creation, else it contains \c nullptr afterwards.
  */
-static CommandCost CreateNewIndustryHelper(TileIndex tile, IndustryType type, DoCommandFlag flags, const IndustrySpec *indspec, size_t layout_index, uint32 random_var8f, uint16 random_initial_bits, Owner founder, IndustryAvailabilityCallType creation_type, Industry **ip)
+static CommandCost CheckNewIndustry(TileIndex tile, IndustryType type, const IndustrySpec *indspec, size_t layout_index, uint32 random_var8f, uint16 random_initial_bits, Owner founder, IndustryAvailabilityCallType creation_type, Town **tp, bool *custom_shape_check)
 {
 	assert(layout_index < indspec->layouts.size());
 	const IndustryTileLayout &layout = indspec->layouts[layout_index];
-	bool custom_shape_check = false;
-
-	*ip = nullptr;
+	*custom_shape_check = false;
 
 	std::vector<ClearedObjectArea> object_areas(_cleared_object_areas);
-	CommandCost ret = CheckIfIndustryTilesAreFree(tile, layout, layout_index, type, random_initial_bits, founder, creation_type, &custom_shape_check);
+	CommandCost ret = CheckIfIndustryTilesAreFree(tile, layout, layout_index, type, random_initial_bits, founder, creation_type, custom_shape_check);
 	_cleared_object_areas = object_areas;
 	if (ret.Failed()) return ret;
 
@@ -1943,7 +1939,7 @@ static CommandCost CreateNewIndustryHelper(TileIndex tile, IndustryType type, Do
 	}
 	if (ret.Failed()) return ret;
 
-	if (!custom_shape_check && _settings_game.game_creation.land_generator == LG_TERRAGENESIS && _generating_world &&
+	if (!*custom_shape_check && _settings_game.game_creation.land_generator == LG_TERRAGENESIS && _generating_world &&
 			!_ignore_restrictions && !CheckIfCanLevelIndustryPlatform(tile, DC_NO_WATER, layout, type)) {
 		return_cmd_error(STR_ERROR_SITE_UNSUITABLE);
 	}
@@ -1961,15 +1957,79 @@ static CommandCost CreateNewIndustryHelper(TileIndex tile, IndustryType type, Do
 
 	if (!Industry::CanAllocateItem()) return_cmd_error(STR_ERROR_TOO_MANY_INDUSTRIES);
 
+	*tp = t;
+	return CommandCost();
+}
+
+/**
+ * Build an industry of which all checks of #CheckNewIndustry have passed.
+ * @param tile tile where industry is built
+ * @param type of industry to build
+ * @param indspec pointer to industry specifications
+ * @param layout_index the index of the itsepc to build/fund
+ * @param random_initial_bits The random bits the industry is going to have after construction.
+ * @param founder Founder of the industry
+ * @param t Town the industry belongs to.
+ * @param custom_shape_check Whether the industry tiles are checked by a NewGRF callback.
+ * @return The newly created industry.
+ */
+static Industry *BuildNewIndustry(TileIndex tile, IndustryType type, const IndustrySpec *indspec, size_t layout_index, uint16 random_initial_bits, Owner founder, Town *t, bool custom_shape_check)
+{
+	const IndustryTileLayout &layout = indspec->layouts[layout_index];
+
+	Industry *i = new Industry(tile);
+	if (!custom_shape_check) CheckIfCanLevelIndustryPlatform(tile, DC_NO_WATER | DC_EXEC, layout, type);
+	DoCreateNewIndustry(i, tile, type, layout, layout_index, t, founder, random_initial_bits);
+	return i;
+}
+
+/**
+ * Helper function for Build/Fund an industry
+ * @param tile tile where industry is built
+ * @param type of industry to build
+ * @param flags of operations to conduct
+ * @param indspec pointer to industry specifications
+ * @param layout_index the index of the itsepc to build/fund
+ * @param random_var8f random seed (possibly) used by industries
+ * @param random_initial_bits The random bits the industry is going to have after construction.
+ * @param founder Founder of the industry
+ * @param creation_type The circumstances the industry is created under.
+ * @param[out] ip Pointer to store newly created industry.
+ * @return Succeeded or failed command.
+ *
+ * @post \c *ip contains the newly created industry if all checks are successful and the \a flags request actual creation, else it contains \c nullptr afterwards.
+ */
+static CommandCost CreateNewIndustryHelper(TileIndex tile, IndustryType type, DoCommandFlag flags, const IndustrySpec *indspec, size_t layout_index, uint32 random_var8f, uint16 random_initial_bits, Owner founder, IndustryAvailabilityCallType creation_type, Industry **ip)
+{
+	*ip = nullptr;
+
+	Town *t = nullptr;
+	bool custom_shape_check = false;
+	CommandCost ret = CheckNewIndustry(tile, type, indspec, layout_index, random_var8f, random_initial_bits, founder, creation_type, &t, &custom_shape_check);
+	if (ret.Failed()) return ret;
+
 	if (flags & DC_EXEC) {
-		*ip = new Industry(tile);
-		if (!custom_shape_check) CheckIfCanLevelIndustryPlatform(tile, DC_NO_WATER | DC_EXEC, layout, type);
-		DoCreateNewIndustry(*ip, tile, type, layout, layout_index, t, founder, random_initial_bits);
+		*ip = BuildNewIndustry(tile, type, indspec, layout_index, random_initial_bits, founder, t, custom_shape_check);
 	}
 
 	return CommandCost();
 }
 
+/** Plan of #CmdBuildIndustry: the layout that passed all checks and what the checks found out. */
+struct BuildIndustryPlan : CommandPlan {
+	size_t layout;           ///< Index of the layout to build.
+	Town *town;              ///< Town the industry belongs to.
+	bool custom_shape_check; ///< Whether the industry tiles are checked by a NewGRF callback.
+
+	BuildIndustryPlan(size_t layout, Town *town, bool custom_shape_check) : layout(layout), town(town), custom_shape_check(custom_shape_check) {}
+
+	bool Equals(const CommandPlan &other) const override
+	{
+		const BuildIndustryPlan &o = static_cast<const BuildIndustryPlan &>(other);
+		return this->layout == o.layout && this->town == o.town && this->custom_shape_check == o.custom_shape_check;
+	}
+};
+
 /**
  * Build/Fund an industry
  * @param tile tile where industry is built
@@ -2041,15 +2101,26 @@ CommandCost CmdBuildIndustry(TileIndex tile, DoCommandFlag flags, uint32 p1, uin
 		size_t layout = GB(p1, 8, 8);
 		if (layout >= num_layouts) return CMD_ERROR;
 
-		/* Check subsequently each layout, starting with the given layout in p1 */
-		for (size_t i = 0; i < num_layouts; i++) {
-			layout = (layout + 1) % num_layouts;
-			ret = CreateNewIndustryHelper(tile, it, flags, indspec, layout, random_var8f, random_initial_bits, _current_company, _current_company == OWNER_DEITY ? IACT_RANDOMCREATION : IACT_USERCREATION, &ind);
-			if (ret.Succeeded()) break;
-		}
+		const BuildIndustryPlan *plan = static_cast<const BuildIndustryPlan *>(GetCommandPlan());
+		if ((flags & DC_EXEC) && plan != nullptr) {
+			/* The test run already found the layout that passes all checks. */
+			ind = BuildNewIndustry(tile, it, indspec, plan->layout, random_initial_bits, _current_company, plan->town, plan->custom_shape_check);
+		} else {
+			/* Check subsequently each layout, starting with the given layout in p1 */
+			Town *t = nullptr;
+			bool custom_shape_check = false;
+			for (size_t i = 0; i < num_layouts; i++) {
+				layout = (layout + 1) % num_layouts;
+				ret = CheckNewIndustry(tile, it, indspec, layout, random_var8f, random_initial_bits, _current_company, _current_company == OWNER_DEITY ? IACT_RANDOMCREATION : IACT_USERCREATION, &t, &custom_shape_check);
+				if (ret.Succeeded()) break;
+			}
 
-		/* If it still failed, there's no suitable layout to build here, return the error */
-		if (ret.Failed()) return ret;
+			/* If it still failed, there's no suitable layout to build here, return the error */
+			if (ret.Failed()) return ret;
+
+			SetCommandPlan(new BuildIndustryPlan(layout, t, custom_shape_check), flags);
+			if (flags & DC_EXEC) ind = BuildNewIndustry(tile, it, indspec, layout, random_initial_bits, _current_company, t, custom_shape_check);
+		}
 	}
 
 	if ((flags & DC_EXEC) && ind != nullptr && _game_mode != GM_EDITOR) {
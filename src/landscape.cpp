@@ -29,6 +29,7 @@
 #include "object_base.h"
 #include "company_func.h"
 #include "pathfinder/npf/aystar.h"
+#include "pathfinder/water_regions.h"
 #include "saveload/saveload.h"
 #include "framerate_type.h"
 #include <array>
@@ -575,6 +576,7 @@ void DoClearSquare(TileIndex tile)
 
 	MakeClear(tile, CLEAR_GRASS, _generating_world ? 3 : 0);
 	MarkTileDirtyByTile(tile);
+	InvalidateWaterRegion(tile);
 }
 
 /**
@@ -1143,19 +1145,6 @@ static void River_FoundEndNode(AyStar *aystar, OpenListNode *current)
 	}
 }
 
-static const uint RIVER_HASH_SIZE = 8; ///< The number of bits the hash for river finding should have.
-
-/**
- * Simple hash function for river tiles to be used by AyStar.
- * @param tile The tile to hash.
- * @param dir The unused direction.
- * @return The hash for the tile.
- */
-static uint River_Hash(uint tile, uint dir)
-{
-	return GB(TileHash(TileX(tile), TileY(tile)), 0, RIVER_HASH_SIZE);
-}
-
 /**
  * Actually build the river between the begin and end tiles using AyStar.
  * @param begin The begin of the river.
@@ -1171,8 +1160,6 @@ static void BuildRiver(TileIndex begin, TileIndex end)
 	finder.FoundEndNode = River_FoundEndNode;
 	finder.user_target = &end;
 
-	finder.Init(River_Hash, 1 << RIVER_HASH_SIZE);
-
 	AyStarNode start;
 	start.tile = begin;
 	start.direction = INVALID_TRACKDIR;
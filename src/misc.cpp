@@ -30,6 +30,10 @@
 #include "town_kdtree.h"
 #include "viewport_kdtree.h"
 #include "newgrf_profiling.h"
+#include "order_base.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/yapf/yapf_cache.h"
+#include "signal_func.h"
 
 #include "safeguards.h"
 
@@ -83,6 +87,7 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	RebuildStationKdtree();
 	RebuildTownKdtree();
 	RebuildViewportKdtree();
+	OrderList::RebuildDestinationIndex();
 
 	ResetPersistentNewGRFData();
 
@@ -107,6 +112,11 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	InitializeBuildingCounts();
 
 	InitializeNPF();
+	InitializeWaterRegions();
+	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+	YapfNotifyRoadLayoutChange(INVALID_TILE);
+	_yapf_road_layout_change_date = INVALID_DATE;
+	InvalidateSignalBlockCache();
 
 	InitializeCompanies();
 	AI::Initialize();
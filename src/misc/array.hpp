@@ -44,12 +44,23 @@ public:
 	{
 	}
 
-	/** Clear (destroy) all items */
+	/** Clear (destroy) all items, but keep the first sub-array for reuse */
 	inline void Clear()
 	{
+		if (data.Length() == 1) {
+			data[0].Clear();
+			return;
+		}
 		data.Clear();
 	}
 
+	/** Return whether adding an item needs a new sub-array */
+	inline bool NeedsSubArray() const
+	{
+		uint super_size = data.Length();
+		return super_size == 0 || data[super_size - 1].IsFull();
+	}
+
 	/** Return actual number of items */
 	inline uint Length() const
 	{
@@ -61,7 +72,7 @@ public:
 	/** return true if array is empty */
 	inline bool IsEmpty()
 	{
-		return data.IsEmpty();
+		return Length() == 0;
 	}
 
 	/** return true if array is full */
@@ -18,8 +18,9 @@ struct CHashTableSlotT
 	typedef typename Titem_::Key Key;          // make Titem_::Key a property of HashTable
 
 	Titem_ *m_pFirst;
+	uint32 m_generation; // generation of the hash table the items were attached in
 
-	inline CHashTableSlotT() : m_pFirst(nullptr) {}
+	inline CHashTableSlotT() : m_pFirst(nullptr), m_generation(0) {}
 
 	/** hash table slot helper - clears the slot by simple forgetting its items */
 	inline void Clear()
@@ -146,12 +147,13 @@ protected:
 	 */
 	typedef CHashTableSlotT<Titem_> Slot;
 
-	Slot  m_slots[Tcapacity]; // here we store our data (array of blobs)
-	int   m_num_items;        // item counter
+	Slot   m_slots[Tcapacity]; // here we store our data (array of blobs)
+	int    m_num_items;        // item counter
+	uint32 m_generation;       // slots of older generations are empty, see Clear()
 
 public:
 	/* default constructor */
-	inline CHashTableT() : m_num_items(0)
+	inline CHashTableT() : m_num_items(0), m_generation(0)
 	{
 	}
 
@@ -172,6 +174,17 @@ protected:
 		return CalcHash(item.GetKey());
 	}
 
+	/** helper - return the slot for the given key, forgetting its items if they belong to a cleared generation */
+	inline Slot &GetSlot(const Tkey &key)
+	{
+		Slot &slot = m_slots[CalcHash(key)];
+		if (slot.m_generation != m_generation) {
+			slot.Clear();
+			slot.m_generation = m_generation;
+		}
+		return slot;
+	}
+
 public:
 	/** item count */
 	inline int Count() const
@@ -179,10 +192,19 @@ public:
 		return m_num_items;
 	}
 
-	/** simple clear - forget all items - used by CSegmentCostCacheT.Flush() */
+	/**
+	 * simple clear - forget all items - used by CSegmentCostCacheT.Flush() and by node lists being reused.
+	 * Only the generation is changed, the slots themselves are emptied when they are used again.
+	 */
 	inline void Clear()
 	{
-		for (int i = 0; i < Tcapacity; i++) m_slots[i].Clear();
+		m_num_items = 0;
+		if (++m_generation != 0) return;
+		/* the generation wrapped around; old slots could be taken for current ones */
+		for (int i = 0; i < Tcapacity; i++) {
+			m_slots[i].Clear();
+			m_slots[i].m_generation = 0;
+		}
 	}
 
 	/** const item search */
@@ -190,6 +212,7 @@ public:
 	{
 		int hash = CalcHash(key);
 		const Slot &slot = m_slots[hash];
+		if (slot.m_generation != m_generation) return nullptr;
 		const Titem_ *item = slot.Find(key);
 		return item;
 	}
@@ -197,8 +220,7 @@ public:
 	/** non-const item search */
 	Titem_ *Find(const Tkey &key)
 	{
-		int hash = CalcHash(key);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(key);
 		Titem_ *item = slot.Find(key);
 		return item;
 	}
@@ -206,8 +228,7 @@ public:
 	/** non-const item search & optional removal (if found) */
 	Titem_ *TryPop(const Tkey &key)
 	{
-		int hash = CalcHash(key);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(key);
 		Titem_ *item = slot.Detach(key);
 		if (item != nullptr) {
 			m_num_items--;
@@ -226,9 +247,7 @@ public:
 	/** non-const item search & optional removal (if found) */
 	bool TryPop(Titem_ &item)
 	{
-		const Tkey &key = item.GetKey();
-		int hash = CalcHash(key);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(item.GetKey());
 		bool ret = slot.Detach(item);
 		if (ret) {
 			m_num_items--;
@@ -247,8 +266,7 @@ public:
 	/** add one item - copy it from the given item */
 	void Push(Titem_ &new_item)
 	{
-		int hash = CalcHash(new_item);
-		Slot &slot = m_slots[hash];
+		Slot &slot = GetSlot(new_item.GetKey());
 		assert(slot.Find(new_item.GetKey()) == nullptr);
 		slot.Attach(new_item);
 		m_num_items++;
@@ -32,6 +32,7 @@
 #include "date_func.h"
 #include "newgrf_debug.h"
 #include "vehicle_func.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 #include "table/object_land.h"
@@ -122,6 +123,8 @@ void BuildObject(ObjectType type, TileIndex tile, CompanyID owner, Town *town, u
 			DirtyCompanyInfrastructureWindows(owner);
 		}
 		MakeObject(t, owner, o->index, wc, Random());
+		/* Objects built on water tiles replace them without clearing them first. */
+		InvalidateWaterRegion(t);
 		MarkTileDirtyByTile(t);
 	}
 
@@ -65,11 +65,17 @@
 #include "viewport_sprite_sorter.h"
 #include "framerate_type.h"
 #include "industry.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/npf/aystar.h"
+#include "pathfinder/yapf/yapf.h"
+#include "pathfinder/yapf/yapf_landmarks.h"
+#include "signal_func.h"
 
 #include "linkgraph/linkgraphschedule.h"
 
 #include <stdarg.h>
 #include <system_error>
+#include <chrono>
 
 #include "safeguards.h"
 
@@ -85,6 +91,7 @@ void MusicLoop();
 void ResetMusic();
 void CallWindowGameTickEvent();
 bool HandleBootstrap();
+static bool RunBenchmark(uint ticks);
 
 extern Company *DoStartupNewCompany(bool is_ai, CompanyID company = INVALID_COMPANY);
 extern void ShowOSErrorBox(const char *buf, bool system);
@@ -198,6 +205,8 @@ static void ShowHelp()
 		"  -c config_file      = Use 'config_file' instead of 'openttd.cfg'\n"
 		"  -x                  = Never save configuration changes to disk\n"
 		"  -q savegame         = Write some information about the savegame and exit\n"
+		"  -B ticks            = Run the savegame given with -g for 'ticks' ticks as fast\n"
+		"                        as possible, write performance statistics and exit\n"
 		"\n",
 		lastof(buf)
 	);
@@ -507,6 +516,7 @@ static const OptionData _options[] = {
 	 GETOPT_SHORT_VALUE('c'),
 	 GETOPT_SHORT_NOVAL('x'),
 	 GETOPT_SHORT_VALUE('q'),
+	 GETOPT_SHORT_VALUE('B'),
 	 GETOPT_SHORT_NOVAL('h'),
 	GETOPT_END()
 };
@@ -529,6 +539,7 @@ int openttd_main(int argc, char *argv[])
 	Dimension resolution = {0, 0};
 	std::unique_ptr<AfterNewGRFScan> scanner(new AfterNewGRFScan());
 	bool dedicated = false;
+	uint benchmark_ticks = 0;
 	char *debuglog_conn = nullptr;
 
 	extern bool _dedicated_forks;
@@ -637,6 +648,7 @@ int openttd_main(int argc, char *argv[])
 		case 'G': scanner->generation_seed = strtoul(mgo.opt, nullptr, 10); break;
 		case 'c': _config_file = mgo.opt; break;
 		case 'x': scanner->save_config = false; break;
+		case 'B': benchmark_ticks = atoi(mgo.opt); break;
 		case 'h':
 			i = -2; // Force printing of help.
 			break;
@@ -662,6 +674,14 @@ int openttd_main(int argc, char *argv[])
 	DeterminePaths(argv[0]);
 	TarScanner::DoScan(TarScanner::BASESET);
 
+	if (benchmark_ticks != 0) {
+		/* Benchmarks only measure the game state, so never draw, play or wait for anything. */
+		videodriver = "null";
+		sounddriver = "null";
+		musicdriver = "null";
+		dedicated = false;
+	}
+
 	if (dedicated) DEBUG(net, 3, "Starting dedicated server, version %s", _openttd_revision);
 	if (_dedicated_forks && !dedicated) _dedicated_forks = false;
 
@@ -793,7 +813,11 @@ int openttd_main(int argc, char *argv[])
 	/* ScanNewGRFFiles now has control over the scanner. */
 	RequestNewGRFScan(scanner.release());
 
-	VideoDriver::GetInstance()->MainLoop();
+	if (benchmark_ticks != 0) {
+		if (!RunBenchmark(benchmark_ticks)) ret = 1;
+	} else {
+		VideoDriver::GetInstance()->MainLoop();
+	}
 
 	WaitTillSaved();
 
@@ -1137,6 +1161,31 @@ static void CheckCaches()
 		i++;
 	}
 
+	/* Check the order destination index. */
+	if (!OrderList::RebuildDestinationIndex()) {
+		DEBUG(desync, 2, "order destination index mismatch");
+	}
+
+	/* Check the water regions of the ship pathfinder. */
+	if (!RebuildWaterRegions()) {
+		DEBUG(desync, 2, "water region mismatch");
+	}
+
+	/* Check the landmark distances of the rail and road pathfinders. */
+	if (!YapfLandmarks::Check()) {
+		DEBUG(desync, 2, "yapf landmark mismatch");
+	}
+
+	/* Check the road vehicle path search results that may still be reused. */
+	if (!YapfCheckRoadPathCache()) {
+		DEBUG(desync, 2, "road path cache mismatch");
+	}
+
+	/* Check the explored signal blocks. */
+	if (!CheckSignalBlockCache()) {
+		DEBUG(desync, 2, "signal block cache mismatch");
+	}
+
 	/* Check company infrastructure cache. */
 	std::vector<CompanyInfrastructure> old_infrastructure;
 	for (const Company *c : Company::Iterate()) old_infrastructure.push_back(c->infrastructure);
@@ -1479,3 +1528,90 @@ void GameLoop()
 	SoundDriver::GetInstance()->MainLoop();
 	MusicLoop();
 }
+
+/**
+ * Calculate a checksum over the game state, so the final state of benchmark runs can be compared.
+ * @return The checksum.
+ */
+static uint32 CalculateGameStateChecksum()
+{
+	/* 32 bits FNV-1a over the raw bytes of the state. */
+	uint32 checksum = 2166136261u;
+	auto add = [&checksum](const void *data, size_t size) {
+		const byte *bytes = (const byte *)data;
+		for (size_t i = 0; i < size; i++) checksum = (checksum ^ bytes[i]) * 16777619u;
+	};
+
+	add(_random.state, sizeof(_random.state));
+	add(&_date, sizeof(_date));
+	add(&_date_fract, sizeof(_date_fract));
+	add(_m, sizeof(*_m) * MapSize());
+	add(_me, sizeof(*_me) * MapSize());
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		add(&v->x_pos, sizeof(v->x_pos));
+		add(&v->y_pos, sizeof(v->y_pos));
+		add(&v->z_pos, sizeof(v->z_pos));
+		add(&v->cur_speed, sizeof(v->cur_speed));
+	}
+	for (const Company *c : Company::Iterate()) {
+		int64 money = c->money;
+		add(&money, sizeof(money));
+	}
+	return checksum;
+}
+
+/**
+ * Load the savegame given on the command line and run the state game loop for a number
+ * of ticks as fast as possible. Afterwards the speed, the time spent per performance
+ * element and a checksum of the final game state are written to standard output.
+ * @param ticks Number of ticks to run.
+ * @return Whether the benchmark could be run.
+ */
+static bool RunBenchmark(uint ticks)
+{
+	/* The savegame is loaded after the NewGRF scan. */
+	if (_request_newgrf_scan) {
+		ScanNewGRFFiles(_request_newgrf_scan_callback);
+		_request_newgrf_scan = false;
+		_request_newgrf_scan_callback = nullptr;
+	}
+
+	if (_switch_mode != SM_LOAD_GAME) {
+		fprintf(stderr, "No savegame to benchmark; use -g to give one\n");
+		return false;
+	}
+
+	SwitchToMode(_switch_mode);
+	_switch_mode = SM_NONE;
+	if (_game_mode != GM_NORMAL) {
+		fprintf(stderr, "Failed to load savegame\n");
+		return false;
+	}
+
+	/* A paused game does not run the state game loop, so there would be nothing to measure. */
+	_pause_mode = PM_UNPAUSED;
+
+	ResetPerformanceTotals();
+	auto start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < ticks; i++) StateGameLoop();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	printf("Ran %u ticks in %.3f seconds: %.1f ticks/second\n", ticks, elapsed.count(), elapsed.count() > 0 ? ticks / elapsed.count() : 0.0);
+	PrintPerformanceTotals(ticks);
+	printf("Checksum: %08x\n", CalculateGameStateChecksum());
+
+	/* Formatting strings does not change the game state, so it can be measured afterwards. */
+	static const uint STRING_ROUNDS = 20;
+	start = std::chrono::steady_clock::now();
+	uint strings = BenchmarkStringFormatting(STRING_ROUNDS);
+	elapsed = std::chrono::steady_clock::now() - start;
+	printf("Formatted %u strings %u times in %.3f seconds: %.2f microseconds/string\n", strings, STRING_ROUNDS, elapsed.count(), strings > 0 ? elapsed.count() * 1e6 / (strings * STRING_ROUNDS) : 0.0);
+
+	/* The same searches with AyStar and with its former node lists, neither changes the game state. */
+	static const uint AYSTAR_SEARCHES = 500;
+	AyStarBenchmarkResult aystar = BenchmarkAyStar(AYSTAR_SEARCHES);
+	printf("AyStar: %u searches, %u paths found, %u cost mismatches\n", aystar.searches, aystar.found, aystar.cost_mismatches);
+	printf("  former node lists: %.3f seconds, " OTTD_PRINTF64 " nodes expanded\n", aystar.legacy_seconds, (int64)aystar.legacy_expanded);
+	printf("  current node lists: %.3f seconds, " OTTD_PRINTF64 " nodes expanded\n", aystar.seconds, (int64)aystar.expanded);
+	return true;
+}
@@ -18,6 +18,7 @@
 #include "station_type.h"
 #include "vehicle_type.h"
 #include "date_type.h"
+#include <vector>
 
 typedef Pool<Order, OrderID, 256, 0xFF0000> OrderPool;
 typedef Pool<OrderList, OrderListID, 128, 64000> OrderListPool;
@@ -390,6 +391,11 @@ public:
 	void FreeChain(bool keep_orderlist = false);
 
 	void DebugCheckSanity() const;
+
+	void UpdateDestinationIndex(const Order *order, bool add);
+
+	static bool RebuildDestinationIndex();
+	static std::vector<const OrderList *> GetByDestination(OrderType type, DestinationID destination);
 };
 
 #endif /* ORDER_BASE_H */
@@ -26,6 +26,7 @@
 #include "company_base.h"
 #include "order_backup.h"
 #include "cheat_type.h"
+#include <map>
 
 #include "table/strings.h"
 
@@ -282,6 +283,112 @@ void Order::AssignOrder(const Order &other)
 	this->max_speed   = other.max_speed;
 }
 
+/** Per destination the number of orders of each order list going there. */
+typedef std::map<DestinationID, std::map<OrderListID, uint>> OrderDestinationIndex;
+
+/**
+ * Index of the order lists with orders going to a destination, so they can
+ * be found without going through the orders of all vehicles.
+ * The first index holds station, waypoint and implicit orders, the second depot orders.
+ * @see OrderList::UpdateDestinationIndex
+ */
+static OrderDestinationIndex _order_destination_index[2];
+
+/**
+ * Get the destination index orders of the given type are kept in.
+ * @param type The type of the orders.
+ * @return The index, or \c nullptr when orders of this type are not indexed.
+ */
+static OrderDestinationIndex *GetOrderDestinationIndex(OrderType type)
+{
+	switch (type) {
+		case OT_GOTO_STATION:
+		case OT_GOTO_WAYPOINT:
+		case OT_IMPLICIT:
+			return &_order_destination_index[0];
+
+		case OT_GOTO_DEPOT:
+			return &_order_destination_index[1];
+
+		default:
+			return nullptr;
+	}
+}
+
+/**
+ * Add an order of this order list to, or remove it from, the destination index.
+ * This must be done whenever an order enters or leaves the list, or its type or
+ * destination changes while it is in the list.
+ * @param order The order.
+ * @param add True when the order is added, false when it is removed.
+ */
+void OrderList::UpdateDestinationIndex(const Order *order, bool add)
+{
+	OrderDestinationIndex *index = GetOrderDestinationIndex(order->GetType());
+	if (index == nullptr) return;
+
+	if (add) {
+		(*index)[order->GetDestination()][this->index]++;
+		return;
+	}
+
+	/* Orders of old savegames are converted in place while loading, so they
+	 * may not be in the index. It is rebuilt after loading anyhow. */
+	auto dest = index->find(order->GetDestination());
+	if (dest == index->end()) return;
+	auto list = dest->second.find(this->index);
+	if (list == dest->second.end()) return;
+
+	if (--list->second == 0) {
+		dest->second.erase(list);
+		if (dest->second.empty()) index->erase(dest);
+	}
+}
+
+/**
+ * Rebuild the destination index from all order lists.
+ * @return True iff the index did not change, i.e. it was up to date.
+ */
+/* static */ bool OrderList::RebuildDestinationIndex()
+{
+	OrderDestinationIndex old_index[lengthof(_order_destination_index)];
+	for (uint i = 0; i < lengthof(_order_destination_index); i++) {
+		old_index[i].swap(_order_destination_index[i]);
+	}
+
+	for (OrderList *list : OrderList::Iterate()) {
+		for (const Order *o = list->first; o != nullptr; o = o->next) list->UpdateDestinationIndex(o, true);
+	}
+
+	for (uint i = 0; i < lengthof(_order_destination_index); i++) {
+		if (old_index[i] != _order_destination_index[i]) return false;
+	}
+	return true;
+}
+
+/**
+ * Get the order lists that might have orders going to the given destination.
+ * For stations this includes station, waypoint and implicit orders, for depots all
+ * depot orders including those to the nearest depot; the caller has to check the
+ * orders of the lists for the exact kind of orders it is interested in.
+ * @param type #OT_GOTO_STATION for stations and waypoints, #OT_GOTO_DEPOT for depots and hangars.
+ * @param destination The station or depot.
+ * @return The order lists, sorted by index.
+ */
+/* static */ std::vector<const OrderList *> OrderList::GetByDestination(OrderType type, DestinationID destination)
+{
+	std::vector<const OrderList *> lists;
+
+	const OrderDestinationIndex *index = GetOrderDestinationIndex(type);
+	assert(index != nullptr);
+
+	auto dest = index->find(destination);
+	if (dest == index->end()) return lists;
+
+	for (const auto &it : dest->second) lists.push_back(OrderList::Get(it.first));
+	return lists;
+}
+
 /**
  * Recomputes everything.
  * @param chain first order in the chain
@@ -301,6 +408,7 @@ void OrderList::Initialize(Order *chain, Vehicle *v)
 		++this->num_orders;
 		if (!o->IsType(OT_IMPLICIT)) ++this->num_manual_orders;
 		this->total_duration += o->GetWaitTime() + o->GetTravelTime();
+		this->UpdateDestinationIndex(o, true);
 	}
 
 	this->RecalculateTimetableDuration();
@@ -335,6 +443,7 @@ void OrderList::FreeChain(bool keep_orderlist)
 	Order *next;
 	for (Order *o = this->first; o != nullptr; o = next) {
 		next = o->next;
+		this->UpdateDestinationIndex(o, false);
 		delete o;
 	}
 
@@ -491,6 +600,7 @@ void OrderList::InsertOrderAt(Order *new_order, int index)
 	if (!new_order->IsType(OT_IMPLICIT)) ++this->num_manual_orders;
 	this->timetable_duration += new_order->GetTimetabledWait() + new_order->GetTimetabledTravel();
 	this->total_duration += new_order->GetWaitTime() + new_order->GetTravelTime();
+	this->UpdateDestinationIndex(new_order, true);
 
 	/* We can visit oil rigs and buoys that are not our own. They will be shown in
 	 * the list of stations. So, we need to invalidate that window if needed. */
@@ -524,6 +634,7 @@ void OrderList::DeleteOrderAt(int index)
 	if (!to_remove->IsType(OT_IMPLICIT)) --this->num_manual_orders;
 	this->timetable_duration -= (to_remove->GetTimetabledWait() + to_remove->GetTimetabledTravel());
 	this->total_duration -= (to_remove->GetWaitTime() + to_remove->GetTravelTime());
+	this->UpdateDestinationIndex(to_remove, false);
 	delete to_remove;
 }
 
@@ -1850,6 +1961,7 @@ restart:
 
 				/* Clear order, preserving travel time */
 				bool travel_timetabled = order->IsTravelTimetabled();
+				v->orders.list->UpdateDestinationIndex(order, false);
 				order->MakeDummy();
 				order->SetTravelTimetabled(travel_timetabled);
 
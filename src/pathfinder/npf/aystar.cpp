@@ -15,67 +15,17 @@
 
 /*
  * Friendly reminder:
- *  Call (AyStar).free() when you are done with Aystar. It reserves a lot of memory
- *  And when not free'd, it can cause system-crashes.
+ *  The memory of the nodes is kept between searches, so following searches
+ *  do not need to allocate it again. Call (AyStar).Free() to release it.
  * Also remember that when you stop an algorithm before it is finished, your
  * should call clear() yourself!
  */
 
 #include "../../stdafx.h"
-#include "../../core/alloc_func.hpp"
 #include "aystar.h"
 
 #include "../../safeguards.h"
 
-/**
- * This looks in the hash whether a node exists in the closed list.
- * @param node Node to search.
- * @return The #PathNode if it is available, else \c nullptr
- */
-PathNode *AyStar::ClosedListIsInList(const AyStarNode *node)
-{
-	return (PathNode*)this->closedlist_hash.Get(node->tile, node->direction);
-}
-
-/**
- * This adds a node to the closed list.
- * It makes a copy of the data.
- * @param node Node to add to the closed list.
- */
-void AyStar::ClosedListAdd(const PathNode *node)
-{
-	/* Add a node to the ClosedList */
-	PathNode *new_node = MallocT<PathNode>(1);
-	*new_node = *node;
-	this->closedlist_hash.Set(node->node.tile, node->node.direction, new_node);
-}
-
-/**
- * Check whether a node is in the open list.
- * @param node Node to search.
- * @return If the node is available, it is returned, else \c nullptr is returned.
- */
-OpenListNode *AyStar::OpenListIsInList(const AyStarNode *node)
-{
-	return (OpenListNode*)this->openlist_hash.Get(node->tile, node->direction);
-}
-
-/**
- * Gets the best node from the open list.
- * It deletes the returned node from the open list.
- * @returns the best node available, or \c nullptr of none is found.
- */
-OpenListNode *AyStar::OpenListPop()
-{
-	/* Return the item the Queue returns.. the best next OpenList item. */
-	OpenListNode *res = (OpenListNode*)this->openlist_queue.Pop();
-	if (res != nullptr) {
-		this->openlist_hash.DeleteValue(res->path.node.tile, res->path.node.direction);
-	}
-
-	return res;
-}
-
 /**
  * Adds a node to the open list.
  * It makes a copy of node, and puts the pointer of parent in the struct.
@@ -83,14 +33,15 @@ OpenListNode *AyStar::OpenListPop()
 void AyStar::OpenListAdd(PathNode *parent, const AyStarNode *node, int f, int g)
 {
 	/* Add a new Node to the OpenList */
-	OpenListNode *new_node = MallocT<OpenListNode>(1);
+	OpenListNode *new_node = this->nodes.Allocate();
 	new_node->g = g;
 	new_node->path.parent = parent;
 	new_node->path.node = *node;
-	this->openlist_hash.Set(node->tile, node->direction, new_node);
+	new_node->priority = f;
+	this->nodes_hash.Insert(new_node);
 
 	/* Add it to the queue */
-	this->openlist_queue.Push(new_node, f);
+	this->openlist_queue.Push(new_node);
 }
 
 /**
@@ -99,8 +50,6 @@ void AyStar::OpenListAdd(PathNode *parent, const AyStarNode *node, int f, int g)
 void AyStar::CheckTile(AyStarNode *current, OpenListNode *parent)
 {
 	int new_f, new_g, new_h;
-	PathNode *closedlist_parent;
-	OpenListNode *check;
 
 	/* Check the new node against the ClosedList */
 	if (this->ClosedListIsInList(current) != nullptr) return;
@@ -124,16 +73,15 @@ void AyStar::CheckTile(AyStarNode *current, OpenListNode *parent)
 	/* The f-value if g + h */
 	new_f = new_g + new_h;
 
-	/* Get the pointer to the parent in the ClosedList (the current one is to a copy of the one in the OpenList) */
-	closedlist_parent = this->ClosedListIsInList(&parent->path.node);
+	/* The parent is closed already, and closed nodes stay where they are */
+	PathNode *closedlist_parent = &parent->path;
 
 	/* Check if this item is already in the OpenList */
-	check = this->OpenListIsInList(current);
+	OpenListNode *check = this->OpenListIsInList(current);
 	if (check != nullptr) {
 		uint i;
 		/* Yes, check if this g value is lower.. */
 		if (new_g > check->g) return;
-		this->openlist_queue.Delete(check, 0);
 		/* It is lower, so change it to this item */
 		check->g = new_g;
 		check->path.parent = closedlist_parent;
@@ -141,8 +89,9 @@ void AyStar::CheckTile(AyStarNode *current, OpenListNode *parent)
 		for (i = 0; i < lengthof(current->user_data); i++) {
 			check->path.node.user_data[i] = current->user_data[i];
 		}
-		/* Re-add it in the openlist_queue. */
-		this->openlist_queue.Push(check, new_f);
+		/* Move it to its new place in the openlist_queue. */
+		check->priority = new_f;
+		this->openlist_queue.Update(check);
 	} else {
 		/* A new node, add it to the OpenList */
 		this->OpenListAdd(closedlist_parent, current, new_f, new_g);
@@ -162,8 +111,8 @@ int AyStar::Loop()
 {
 	int i;
 
-	/* Get the best node from OpenList */
-	OpenListNode *current = this->OpenListPop();
+	/* Get the best node from OpenList; from now on it is not in the OpenList anymore */
+	OpenListNode *current = this->openlist_queue.Pop();
 	/* If empty, drop an error */
 	if (current == nullptr) return AYSTAR_EMPTY_OPENLIST;
 
@@ -172,12 +121,11 @@ int AyStar::Loop()
 		if (this->FoundEndNode != nullptr) {
 			this->FoundEndNode(this, current);
 		}
-		free(current);
 		return AYSTAR_FOUND_END_NODE;
 	}
 
-	/* Add the node to the ClosedList */
-	this->ClosedListAdd(&current->path);
+	/* The node is in the ClosedList now */
+	this->closedlist_size++;
 
 	/* Load the neighbours */
 	this->GetNeighbours(this, current);
@@ -188,10 +136,7 @@ int AyStar::Loop()
 		this->CheckTile(&this->neighbours[i], current);
 	}
 
-	/* Free the node */
-	free(current);
-
-	if (this->max_search_nodes != 0 && this->closedlist_hash.GetSize() >= this->max_search_nodes) {
+	if (this->max_search_nodes != 0 && this->closedlist_size >= this->max_search_nodes) {
 		/* We've expanded enough nodes */
 		return AYSTAR_LIMIT_REACHED;
 	} else {
@@ -205,11 +150,10 @@ int AyStar::Loop()
  */
 void AyStar::Free()
 {
-	this->openlist_queue.Free(false);
-	/* 2nd argument above is false, below is true, to free the values only
-	 * once */
-	this->openlist_hash.Delete(true);
-	this->closedlist_hash.Delete(true);
+	this->openlist_queue.Free();
+	this->nodes_hash.Free();
+	this->nodes.Free();
+	this->closedlist_size = 0;
 #ifdef AYSTAR_DEBUG
 	printf("[AyStar] Memory free'd\n");
 #endif
@@ -221,12 +165,11 @@ void AyStar::Free()
  */
 void AyStar::Clear()
 {
-	/* Clean the Queue, but not the elements within. That will be done by
-	 * the hash. */
-	this->openlist_queue.Clear(false);
-	/* Clean the hashes */
-	this->openlist_hash.Clear(true);
-	this->closedlist_hash.Clear(true);
+	/* Forget all nodes, but keep the memory for the next search. */
+	this->openlist_queue.Clear();
+	this->nodes_hash.Clear();
+	this->nodes.Clear();
+	this->closedlist_size = 0;
 
 #ifdef AYSTAR_DEBUG
 	printf("[AyStar] Cleared AyStar\n");
@@ -283,22 +226,12 @@ void AyStar::AddStartNode(AyStarNode *start_node, uint g)
 	printf("[AyStar] Starting A* Algorithm from node (%d, %d, %d)\n",
 		TileX(start_node->tile), TileY(start_node->tile), start_node->direction);
 #endif
-	this->OpenListAdd(nullptr, start_node, 0, g);
-}
-
-/**
- * Initialize an #AyStar. You should fill all appropriate fields before
- * calling #Init (see the declaration of #AyStar for which fields are internal).
- */
-void AyStar::Init(Hash_HashProc hash, uint num_buckets)
-{
-	/* Allocated the Hash for the OpenList and ClosedList */
-	this->openlist_hash.Init(hash, num_buckets);
-	this->closedlist_hash.Init(hash, num_buckets);
-
-	/* Set up our sorting queue
-	 *  BinaryHeap allocates a block of 1024 nodes
-	 *  When that one gets full it reserves another one, till this number
-	 *  That is why it can stay this high */
-	this->openlist_queue.Init(102400);
+	/* A node can only be in the open list once; keep the cheapest start. */
+	OpenListNode *check = this->OpenListIsInList(start_node);
+	if (check == nullptr) {
+		this->OpenListAdd(nullptr, start_node, 0, g);
+	} else if ((int)g < check->g) {
+		check->g = g;
+		check->path.node = *start_node;
+	}
 }
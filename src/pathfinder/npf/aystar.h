@@ -55,6 +55,11 @@ struct PathNode {
 struct OpenListNode {
 	int g;
 	PathNode path;
+	int priority;    ///< The f-value of the node, used by the open list.
+	uint heap_index; ///< Position of the node in the open list; #NodeHeap::NOT_IN_HEAP once it is closed.
+
+	inline TileIndex GetTile() const { return this->path.node.tile; }
+	inline Trackdir GetDirection() const { return this->path.node.direction; }
 };
 
 bool CheckIgnoreFirstTile(const PathNode *node);
@@ -107,15 +112,15 @@ typedef void AyStar_FoundEndNode(AyStar *aystar, OpenListNode *current);
 
 /**
  * %AyStar search algorithm struct.
- * Before calling #Init(), fill #CalculateG, #CalculateH, #GetNeighbours, #EndNodeCheck, and #FoundEndNode.
- * If you want to change them after calling #Init(), first call #Free() !
+ * Before adding start nodes, fill #CalculateG, #CalculateH, #GetNeighbours, #EndNodeCheck, and #FoundEndNode.
+ * They can be changed between searches, i.e. when no search is in progress.
  *
  * The #user_path, #user_target, and #user_data[10] are intended to be used by the user routines. The data not accessed by the #AyStar code itself.
  * The user routines can change any moment they like.
  */
 struct AyStar {
-/* These fields should be filled before initing the AyStar, but not changed
- * afterwards (except for user_data and user_path)! (free and init again to change them) */
+/* These fields should be filled before starting a search, but not changed
+ * during it (except for user_data and user_path)! */
 
 	/* These should point to the application specific routines that do the
 	 * actual work */
@@ -144,8 +149,6 @@ struct AyStar {
 	AyStarNode neighbours[12];
 	byte num_neighbours;
 
-	void Init(Hash_HashProc hash, uint num_buckets);
-
 	/* These will contain the methods for manipulating the AyStar. Only
 	 * Main() should be called externally */
 	void AddStartNode(AyStarNode *start_node, uint g);
@@ -156,16 +159,47 @@ struct AyStar {
 	void CheckTile(AyStarNode *current, OpenListNode *parent);
 
 protected:
-	Hash       closedlist_hash; ///< The actual closed list.
-	BinaryHeap openlist_queue;  ///< The open queue.
-	Hash       openlist_hash;   ///< An extra hash to speed up the process of looking up an element in the open list.
+	NodeArena<OpenListNode> nodes;              ///< Storage of the open and closed nodes.
+	NodeHash<OpenListNode>  nodes_hash;         ///< The open and closed nodes by tile and trackdir.
+	NodeHeap<OpenListNode>  openlist_queue;     ///< The open nodes, by their f-value.
+	uint                    closedlist_size = 0; ///< Number of closed nodes.
 
 	void OpenListAdd(PathNode *parent, const AyStarNode *node, int f, int g);
-	OpenListNode *OpenListIsInList(const AyStarNode *node);
-	OpenListNode *OpenListPop();
 
-	void ClosedListAdd(const PathNode *node);
-	PathNode *ClosedListIsInList(const AyStarNode *node);
+	/**
+	 * Check whether a node is in the open list.
+	 * @param node Node to search.
+	 * @return If the node is available, it is returned, else \c nullptr is returned.
+	 */
+	inline OpenListNode *OpenListIsInList(const AyStarNode *node) const
+	{
+		OpenListNode *res = this->nodes_hash.Find(node->tile, node->direction);
+		return res != nullptr && res->heap_index != NodeHeap<OpenListNode>::NOT_IN_HEAP ? res : nullptr;
+	}
+
+	/**
+	 * Check whether a node is in the closed list.
+	 * @param node Node to search.
+	 * @return If the node is available, it is returned, else \c nullptr is returned.
+	 */
+	inline OpenListNode *ClosedListIsInList(const AyStarNode *node) const
+	{
+		OpenListNode *res = this->nodes_hash.Find(node->tile, node->direction);
+		return res != nullptr && res->heap_index == NodeHeap<OpenListNode>::NOT_IN_HEAP ? res : nullptr;
+	}
 };
 
+/** Results of #BenchmarkAyStar. */
+struct AyStarBenchmarkResult {
+	uint searches;          ///< Number of searches done by both versions.
+	uint found;             ///< Number of searches that found a path.
+	uint cost_mismatches;   ///< Number of searches where both versions disagree on the path cost.
+	uint64 expanded;        ///< Nodes expanded by %AyStar.
+	uint64 legacy_expanded; ///< Nodes expanded by the former node lists.
+	double seconds;         ///< Time spent by %AyStar.
+	double legacy_seconds;  ///< Time spent by the former node lists.
+};
+
+AyStarBenchmarkResult BenchmarkAyStar(uint searches);
+
 #endif /* AYSTAR_H */
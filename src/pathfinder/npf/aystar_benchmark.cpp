@@ -0,0 +1,476 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file aystar_benchmark.cpp Side by side benchmark of %AyStar and its former node lists.
+ *
+ * #LegacyAyStar keeps the node lists %AyStar used before the arena, flat hash
+ * and indexed heap of queue.h: every node is malloc'd, the open and closed
+ * nodes live in two chained hashes with a fixed number of buckets, closing a
+ * node copies it, and the binary heap searches linearly for a node whose cost
+ * is lowered. It is only used to compare both versions on the same map.
+ */
+
+#include "../../stdafx.h"
+#include "../../core/alloc_func.hpp"
+#include "../../map_func.h"
+#include "../../road.h"
+#include "../../tile_cmd.h"
+#include "../../tunnelbridge_map.h"
+#include "../../track_func.h"
+#include "../pathfinder_type.h"
+#include "aystar.h"
+#include <chrono>
+#include <memory>
+
+#include "../../safeguards.h"
+
+static const uint LEGACY_HASH_BITS = 12;                      ///< Number of bits of the hash of #LegacyHash, as NPF used.
+static const uint LEGACY_HASH_HALFBITS = LEGACY_HASH_BITS / 2; ///< Number of bits used per coordinate.
+static const uint LEGACY_HASH_HALFMASK = (1 << LEGACY_HASH_HALFBITS) - 1;
+static const uint LEGACY_HASH_SIZE = 1 << LEGACY_HASH_BITS;    ///< Number of buckets of #LegacyHash.
+
+static const int BENCHMARK_CORNER_COST = NPF_TILE_LENGTH * STRAIGHT_TRACK_LENGTH; ///< Cost of a corner track in the benchmark searches.
+
+/** Chained hash of node pointers by tile and trackdir, with a fixed number of buckets. */
+struct LegacyHash {
+	/** Entry of the hash; the first entry of each bucket is stored in the bucket itself. */
+	struct HashNode {
+		TileIndex tile;
+		Trackdir direction;
+		void *value;
+		HashNode *next;
+	};
+
+	HashNode buckets[LEGACY_HASH_SIZE]; ///< The buckets.
+	bool in_use[LEGACY_HASH_SIZE];      ///< Whether the first entry of a bucket is used.
+	uint size;                          ///< Number of entries.
+
+	LegacyHash() : in_use(), size(0) {}
+
+	/** The hash NPF used: the low bits of both coordinates plus a part for the trackdir. */
+	static uint Hash(TileIndex tile, Trackdir direction)
+	{
+		uint part1 = TileX(tile) & LEGACY_HASH_HALFMASK;
+		uint part2 = TileY(tile) & LEGACY_HASH_HALFMASK;
+		return ((part1 << LEGACY_HASH_HALFBITS | part2) + (LEGACY_HASH_SIZE * direction / TRACKDIR_END)) % LEGACY_HASH_SIZE;
+	}
+
+	/**
+	 * Find the entry of a key.
+	 * @param tile Tile of the key.
+	 * @param direction Trackdir of the key.
+	 * @param[out] prev_out The entry before the found one, or the last entry of the bucket if none is found; \c nullptr for the first entry of a bucket.
+	 * @return The entry, or \c nullptr if the key is not in the hash.
+	 */
+	HashNode *FindNode(TileIndex tile, Trackdir direction, HashNode **prev_out)
+	{
+		uint hash = Hash(tile, direction);
+		*prev_out = nullptr;
+		if (!this->in_use[hash]) return nullptr;
+		if (this->buckets[hash].tile == tile && this->buckets[hash].direction == direction) return &this->buckets[hash];
+
+		HashNode *prev = &this->buckets[hash];
+		for (HashNode *node = prev->next; node != nullptr; node = node->next) {
+			if (node->tile == tile && node->direction == direction) {
+				*prev_out = prev;
+				return node;
+			}
+			prev = node;
+		}
+		*prev_out = prev;
+		return nullptr;
+	}
+
+	void *Get(TileIndex tile, Trackdir direction)
+	{
+		HashNode *prev;
+		HashNode *node = this->FindNode(tile, direction, &prev);
+		return node != nullptr ? node->value : nullptr;
+	}
+
+	void Set(TileIndex tile, Trackdir direction, void *value)
+	{
+		HashNode *prev;
+		HashNode *node = this->FindNode(tile, direction, &prev);
+		if (node != nullptr) {
+			node->value = value;
+			return;
+		}
+		if (prev == nullptr) {
+			uint hash = Hash(tile, direction);
+			this->in_use[hash] = true;
+			node = &this->buckets[hash];
+		} else {
+			node = MallocT<HashNode>(1);
+			prev->next = node;
+		}
+		node->tile = tile;
+		node->direction = direction;
+		node->value = value;
+		node->next = nullptr;
+		this->size++;
+	}
+
+	void DeleteValue(TileIndex tile, Trackdir direction)
+	{
+		HashNode *prev;
+		HashNode *node = this->FindNode(tile, direction, &prev);
+		if (node == nullptr) return;
+		if (prev == nullptr) {
+			/* The first entry is part of the bucket; move the second one over it. */
+			if (node->next != nullptr) {
+				HashNode *next = node->next;
+				*node = *next;
+				free(next);
+			} else {
+				this->in_use[Hash(tile, direction)] = false;
+			}
+		} else {
+			prev->next = node->next;
+			free(node);
+		}
+		this->size--;
+	}
+
+	/**
+	 * Remove all entries.
+	 * @param free_values Whether to free the values too.
+	 */
+	void Clear(bool free_values)
+	{
+		for (uint i = 0; i < LEGACY_HASH_SIZE; i++) {
+			if (!this->in_use[i]) continue;
+			this->in_use[i] = false;
+			if (free_values) free(this->buckets[i].value);
+			HashNode *node = this->buckets[i].next;
+			while (node != nullptr) {
+				HashNode *prev = node;
+				node = node->next;
+				if (free_values) free(prev->value);
+				free(prev);
+			}
+		}
+		this->size = 0;
+	}
+};
+
+/** Binary heap of node pointers; deleting a node searches the heap for it. */
+struct LegacyBinaryHeap {
+	/** Entry of the heap. */
+	struct HeapNode {
+		void *item;
+		int priority;
+	};
+
+	HeapNode *elements = nullptr; ///< The entries, starting at index 1.
+	uint size = 0;                ///< Number of entries.
+	uint capacity = 0;            ///< Number of allocated entries.
+
+	~LegacyBinaryHeap()
+	{
+		free(this->elements);
+	}
+
+	void Push(void *item, int priority)
+	{
+		if (this->size + 1 >= this->capacity) {
+			this->capacity = std::max(1024U, this->capacity * 2);
+			this->elements = ReallocT(this->elements, this->capacity);
+		}
+		this->size++;
+		this->elements[this->size].item = item;
+		this->elements[this->size].priority = priority;
+
+		/* As long as the parent is not smaller, switch with it. */
+		for (uint i = this->size; i > 1; i /= 2) {
+			if (this->elements[i].priority > this->elements[i / 2].priority) break;
+			std::swap(this->elements[i], this->elements[i / 2]);
+		}
+	}
+
+	void Delete(void *item)
+	{
+		uint i = 1;
+		while (i <= this->size && this->elements[i].item != item) i++;
+		if (i > this->size) return;
+
+		this->elements[i] = this->elements[this->size];
+		this->size--;
+		for (;;) {
+			uint j = i;
+			if (2 * j + 1 <= this->size) {
+				if (this->elements[j].priority >= this->elements[2 * j].priority) i = 2 * j;
+				if (this->elements[i].priority >= this->elements[2 * j + 1].priority) i = 2 * j + 1;
+			} else if (2 * j <= this->size) {
+				if (this->elements[j].priority >= this->elements[2 * j].priority) i = 2 * j;
+			}
+			if (i == j) break;
+			std::swap(this->elements[i], this->elements[j]);
+		}
+	}
+
+	void *Pop()
+	{
+		if (this->size == 0) return nullptr;
+		void *result = this->elements[1].item;
+		this->Delete(result);
+		return result;
+	}
+};
+
+/**
+ * %AyStar with the node lists it had before.
+ * It uses the callbacks and settings of #AyStar, but none of its node lists.
+ */
+struct LegacyAyStar : AyStar {
+	LegacyHash openlist_hash;
+	LegacyHash closedlist_hash;
+	LegacyBinaryHeap legacy_queue;
+
+	~LegacyAyStar()
+	{
+		this->LegacyClear();
+	}
+
+	void LegacyOpenListAdd(PathNode *parent, const AyStarNode *node, int f, int g)
+	{
+		OpenListNode *new_node = MallocT<OpenListNode>(1);
+		new_node->g = g;
+		new_node->path.parent = parent;
+		new_node->path.node = *node;
+		this->openlist_hash.Set(node->tile, node->direction, new_node);
+		this->legacy_queue.Push(new_node, f);
+	}
+
+	void LegacyAddStartNode(AyStarNode *start_node, uint g)
+	{
+		this->LegacyOpenListAdd(nullptr, start_node, 0, g);
+	}
+
+	void LegacyCheckTile(AyStarNode *current, OpenListNode *parent)
+	{
+		if (this->closedlist_hash.Get(current->tile, current->direction) != nullptr) return;
+
+		int new_g = this->CalculateG(this, current, parent);
+		if (new_g == AYSTAR_INVALID_NODE) return;
+		new_g += parent->g;
+		if (this->max_path_cost != 0 && (uint)new_g > this->max_path_cost) return;
+		int new_f = new_g + this->CalculateH(this, current, parent);
+
+		/* The parent was copied into the closed list; link to that copy. */
+		PathNode *closedlist_parent = (PathNode *)this->closedlist_hash.Get(parent->path.node.tile, parent->path.node.direction);
+
+		OpenListNode *check = (OpenListNode *)this->openlist_hash.Get(current->tile, current->direction);
+		if (check != nullptr) {
+			if (new_g > check->g) return;
+			this->legacy_queue.Delete(check);
+			check->g = new_g;
+			check->path.parent = closedlist_parent;
+			for (uint i = 0; i < lengthof(current->user_data); i++) {
+				check->path.node.user_data[i] = current->user_data[i];
+			}
+			this->legacy_queue.Push(check, new_f);
+		} else {
+			this->LegacyOpenListAdd(closedlist_parent, current, new_f, new_g);
+		}
+	}
+
+	int LegacyLoop()
+	{
+		OpenListNode *current = (OpenListNode *)this->legacy_queue.Pop();
+		if (current == nullptr) return AYSTAR_EMPTY_OPENLIST;
+		this->openlist_hash.DeleteValue(current->path.node.tile, current->path.node.direction);
+
+		if (this->EndNodeCheck(this, current) == AYSTAR_FOUND_END_NODE && !CheckIgnoreFirstTile(&current->path)) {
+			if (this->FoundEndNode != nullptr) this->FoundEndNode(this, current);
+			free(current);
+			return AYSTAR_FOUND_END_NODE;
+		}
+
+		PathNode *closed = MallocT<PathNode>(1);
+		*closed = current->path;
+		this->closedlist_hash.Set(closed->node.tile, closed->node.direction, closed);
+
+		this->GetNeighbours(this, current);
+		for (int i = 0; i < this->num_neighbours; i++) {
+			this->LegacyCheckTile(&this->neighbours[i], current);
+		}
+		free(current);
+
+		if (this->max_search_nodes != 0 && this->closedlist_hash.size >= this->max_search_nodes) return AYSTAR_LIMIT_REACHED;
+		return AYSTAR_STILL_BUSY;
+	}
+
+	void LegacyClear()
+	{
+		this->legacy_queue.size = 0;
+		this->openlist_hash.Clear(true);
+		this->closedlist_hash.Clear(true);
+	}
+
+	int LegacyMain()
+	{
+		int r;
+		while ((r = this->LegacyLoop()) == AYSTAR_STILL_BUSY) { }
+		this->LegacyClear();
+		return r == AYSTAR_FOUND_END_NODE ? AYSTAR_FOUND_END_NODE : AYSTAR_NO_PATH;
+	}
+};
+
+/** Target and statistics of one benchmark search. */
+struct BenchmarkTarget {
+	TileIndex tile;          ///< Tile to find.
+	TransportType type;      ///< Transport type to follow.
+	int cost;                ///< Cost of the found path.
+	uint expanded;           ///< Number of nodes expanded.
+};
+
+/**
+ * Get the trackdirs on a tile.
+ * @param tile The tile.
+ * @param type The transport type.
+ * @return The trackdirs.
+ */
+static TrackdirBits GetBenchmarkTrackdirs(TileIndex tile, TransportType type)
+{
+	return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, type, type == TRANSPORT_ROAD ? RTT_ROAD : 0));
+}
+
+/** Cost of leaving the tile of a node: a full tile for a straight track, less for a corner. */
+static int32 BenchmarkCalculateG(AyStar *aystar, AyStarNode *current, OpenListNode *parent)
+{
+	return IsDiagonalTrackdir(current->direction) ? NPF_TILE_LENGTH : BENCHMARK_CORNER_COST;
+}
+
+/** Distance to the target, never more than the cost of reaching it. */
+static int32 BenchmarkCalculateH(AyStar *aystar, AyStarNode *current, OpenListNode *parent)
+{
+	const BenchmarkTarget *target = (const BenchmarkTarget *)aystar->user_target;
+	return DistanceManhattan(current->tile, target->tile) * BENCHMARK_CORNER_COST;
+}
+
+/** Follow the track to the next tile; tunnels and bridges are not passed. */
+static void BenchmarkGetNeighbours(AyStar *aystar, OpenListNode *current)
+{
+	BenchmarkTarget *target = (BenchmarkTarget *)aystar->user_target;
+	target->expanded++;
+	aystar->num_neighbours = 0;
+
+	TileIndex tile = current->GetTile();
+	DiagDirection exitdir = TrackdirToExitdir(current->GetDirection());
+	if (IsTileType(tile, MP_TUNNELBRIDGE) && GetTunnelBridgeDirection(tile) == exitdir) return;
+
+	TileIndex next = TileAddByDiagDir(tile, exitdir);
+	if (!IsValidTile(next)) return;
+	if (IsTileType(next, MP_TUNNELBRIDGE) && GetTunnelBridgeDirection(next) != exitdir) return;
+
+	TrackdirBits trackdirs = GetBenchmarkTrackdirs(next, target->type) & DiagdirReachesTrackdirs(exitdir);
+	while (trackdirs != TRACKDIR_BIT_NONE) {
+		AyStarNode *neighbour = &aystar->neighbours[aystar->num_neighbours++];
+		neighbour->tile = next;
+		neighbour->direction = RemoveFirstTrackdir(&trackdirs);
+		neighbour->user_data[0] = neighbour->user_data[1] = 0;
+	}
+}
+
+static int32 BenchmarkEndNodeCheck(const AyStar *aystar, const OpenListNode *current)
+{
+	const BenchmarkTarget *target = (const BenchmarkTarget *)aystar->user_target;
+	return current->GetTile() == target->tile ? AYSTAR_FOUND_END_NODE : AYSTAR_DONE;
+}
+
+static void BenchmarkFoundEndNode(AyStar *aystar, OpenListNode *current)
+{
+	BenchmarkTarget *target = (BenchmarkTarget *)aystar->user_target;
+	target->cost = current->g;
+}
+
+/**
+ * Run the same searches between rail and road tiles of the current map with
+ * %AyStar and with #LegacyAyStar. The pairs of tiles are chosen by a local
+ * generator, so the game state does not change.
+ * @param searches Number of searches per transport type.
+ * @return The timings and the differences between both.
+ */
+AyStarBenchmarkResult BenchmarkAyStar(uint searches)
+{
+	AyStarBenchmarkResult result = {};
+
+	/* The NPF default; it keeps searches between unconnected tiles short. */
+	static const uint MAX_SEARCH_NODES = 10000;
+
+	AyStar aystar;
+	/* The buckets of both hashes are too large for the stack. */
+	std::unique_ptr<LegacyAyStar> legacy(new LegacyAyStar());
+	for (AyStar *as : { &aystar, (AyStar *)legacy.get() }) {
+		as->CalculateG = BenchmarkCalculateG;
+		as->CalculateH = BenchmarkCalculateH;
+		as->GetNeighbours = BenchmarkGetNeighbours;
+		as->EndNodeCheck = BenchmarkEndNodeCheck;
+		as->FoundEndNode = BenchmarkFoundEndNode;
+		as->loops_per_tick = 0;
+		as->max_path_cost = 0;
+		as->max_search_nodes = MAX_SEARCH_NODES;
+	}
+
+	for (TransportType type : { TRANSPORT_RAIL, TRANSPORT_ROAD }) {
+		std::vector<TileIndex> tiles;
+		for (TileIndex tile = 0; tile < MapSize(); tile++) {
+			if (GetBenchmarkTrackdirs(tile, type) != TRACKDIR_BIT_NONE) tiles.push_back(tile);
+		}
+		if (tiles.size() < 2) continue;
+
+		std::vector<std::pair<TileIndex, TileIndex>> pairs;
+		uint32 seed = 12345;
+		for (uint i = 0; i < searches; i++) {
+			seed = seed * 1103515245 + 12345;
+			TileIndex from = tiles[(seed >> 8) % tiles.size()];
+			seed = seed * 1103515245 + 12345;
+			TileIndex to = tiles[(seed >> 8) % tiles.size()];
+			pairs.emplace_back(from, to);
+		}
+
+		std::vector<BenchmarkTarget> targets[2];
+		for (uint engine = 0; engine < 2; engine++) {
+			auto start = std::chrono::steady_clock::now();
+			for (const auto &pair : pairs) {
+				BenchmarkTarget target = { pair.second, type, -1, 0 };
+				AyStar *as = engine == 0 ? (AyStar *)legacy.get() : &aystar;
+				as->user_target = &target;
+				TrackdirBits trackdirs = GetBenchmarkTrackdirs(pair.first, type);
+				while (trackdirs != TRACKDIR_BIT_NONE) {
+					AyStarNode start_node = { pair.first, RemoveFirstTrackdir(&trackdirs), { 0, 0 } };
+					if (engine == 0) {
+						legacy->LegacyAddStartNode(&start_node, 0);
+					} else {
+						aystar.AddStartNode(&start_node, 0);
+					}
+				}
+				if (engine == 0) {
+					legacy->LegacyMain();
+				} else {
+					aystar.Main();
+				}
+				targets[engine].push_back(target);
+			}
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			(engine == 0 ? result.legacy_seconds : result.seconds) += elapsed.count();
+		}
+
+		for (uint i = 0; i < pairs.size(); i++) {
+			result.searches++;
+			if (targets[1][i].cost >= 0) result.found++;
+			result.legacy_expanded += targets[0][i].expanded;
+			result.expanded += targets[1][i].expanded;
+			if (targets[0][i].cost != targets[1][i].cost) result.cost_mismatches++;
+		}
+	}
+
+	aystar.Free();
+	return result;
+}
@@ -5,105 +5,298 @@
  * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
  */
 
-/** @file queue.h Binary heap implementation, hash implementation. */
+/** @file queue.h Containers for the nodes of %AyStar: node arena, indexed heap and node hash. */
 
 #ifndef QUEUE_H
 #define QUEUE_H
 
-//#define HASH_STATS
+#include "../../tile_type.h"
+#include "../../track_type.h"
+#include <vector>
+#include <memory>
 
+/**
+ * Storage of the nodes of a search.
+ * The nodes never move, so pointers to them stay valid until #Clear.
+ * The memory is kept when clearing, so following searches do not allocate
+ * again until they need more nodes than the searches before.
+ * @tparam Titem Type of the nodes.
+ */
+template <class Titem>
+class NodeArena {
+	static const uint BLOCK_SIZE = 1024; ///< Number of nodes allocated at a time.
 
-struct BinaryHeapNode {
-	void *item;
-	int priority;
-};
+	std::vector<std::unique_ptr<Titem[]>> blocks; ///< The allocated blocks of nodes.
+	uint used = 0;                                ///< Number of nodes handed out since the last #Clear.
+
+public:
+	/**
+	 * Get storage for a new node.
+	 * @return The node; its contents are undefined.
+	 */
+	inline Titem *Allocate()
+	{
+		if (this->used == this->blocks.size() * BLOCK_SIZE) this->blocks.emplace_back(new Titem[BLOCK_SIZE]);
+		Titem *item = &this->blocks[this->used / BLOCK_SIZE][this->used % BLOCK_SIZE];
+		this->used++;
+		return item;
+	}
+
+	/** Forget all nodes, but keep their memory. */
+	inline void Clear()
+	{
+		this->used = 0;
+	}
 
+	/** Forget all nodes and release their memory. */
+	inline void Free()
+	{
+		this->blocks.clear();
+		this->used = 0;
+	}
+};
 
 /**
- * Binary Heap.
- * For information, see: http://www.policyalmanac.org/games/binaryHeaps.htm
+ * Indexed d-ary min-heap of nodes.
+ * The nodes store their priority and their position in the heap, so a node
+ * can be moved when its priority changes without searching for it.
+ * Of nodes with the same priority, the one pushed last tends to be popped first.
+ * @tparam Titem Type of the nodes; needs the members \c int \c priority and \c uint \c heap_index.
+ * @tparam Tarity Number of children of each element of the heap.
  */
-struct BinaryHeap {
-	static const int BINARY_HEAP_BLOCKSIZE;
-	static const int BINARY_HEAP_BLOCKSIZE_BITS;
-	static const int BINARY_HEAP_BLOCKSIZE_MASK;
+template <class Titem, uint Tarity = 4>
+class NodeHeap {
+	std::vector<Titem *> items; ///< The nodes in heap order.
 
-	void Init(uint max_size);
+	/**
+	 * Put a node at a position in the heap.
+	 * @param item The node.
+	 * @param index The position.
+	 */
+	inline void Place(Titem *item, uint index)
+	{
+		this->items[index] = item;
+		item->heap_index = index;
+	}
 
-	bool Push(void *item, int priority);
-	void *Pop();
-	bool Delete(void *item, int priority);
-	void Clear(bool free_values);
-	void Free(bool free_values);
+	/**
+	 * Move a node towards the top until its parent has a lower priority.
+	 * @param item The node.
+	 * @param index The position to start at; its current content is overwritten.
+	 */
+	void SiftUp(Titem *item, uint index)
+	{
+		while (index > 0) {
+			uint parent = (index - 1) / Tarity;
+			if (this->items[parent]->priority < item->priority) break;
+			this->Place(this->items[parent], index);
+			index = parent;
+		}
+		this->Place(item, index);
+	}
 
 	/**
-	 * Get an element from the #elements.
-	 * @param i Element to access (starts at offset \c 1).
-	 * @return Value of the element.
+	 * Move a node towards the bottom until none of its children has a lower priority.
+	 * @param item The node.
+	 * @param index The position to start at; its current content is overwritten.
 	 */
-	inline BinaryHeapNode &GetElement(uint i)
+	void SiftDown(Titem *item, uint index)
 	{
-		assert(i > 0);
-		return this->elements[(i - 1) >> BINARY_HEAP_BLOCKSIZE_BITS][(i - 1) & BINARY_HEAP_BLOCKSIZE_MASK];
+		uint size = (uint)this->items.size();
+		for (;;) {
+			uint first = index * Tarity + 1;
+			if (first >= size) break;
+
+			uint last = std::min(first + Tarity, size);
+			uint best = first;
+			for (uint child = first + 1; child < last; child++) {
+				if (this->items[child]->priority < this->items[best]->priority) best = child;
+			}
+			if (this->items[best]->priority >= item->priority) break;
+
+			this->Place(this->items[best], index);
+			index = best;
+		}
+		this->Place(item, index);
 	}
 
-	uint max_size;
-	uint size;
-	uint blocks; ///< The amount of blocks for which space is reserved in elements
-	BinaryHeapNode **elements;
-};
+public:
+	static const uint NOT_IN_HEAP = UINT_MAX; ///< #heap_index of nodes that are not in the heap.
 
+	/**
+	 * Check whether the heap is empty.
+	 * @return True iff there are no nodes in the heap.
+	 */
+	inline bool IsEmpty() const
+	{
+		return this->items.empty();
+	}
 
-/*
- * Hash
- */
-struct HashNode {
-	uint key1;
-	uint key2;
-	void *value;
-	HashNode *next;
+	/**
+	 * Add a node to the heap.
+	 * @param item The node, not in the heap yet.
+	 */
+	void Push(Titem *item)
+	{
+		this->items.push_back(item);
+		this->SiftUp(item, (uint)this->items.size() - 1);
+	}
+
+	/**
+	 * Remove the node with the lowest priority from the heap.
+	 * @return The node, or \c nullptr if the heap is empty.
+	 */
+	Titem *Pop()
+	{
+		if (this->items.empty()) return nullptr;
+
+		Titem *result = this->items.front();
+		Titem *last = this->items.back();
+		this->items.pop_back();
+		if (!this->items.empty()) this->SiftDown(last, 0);
+
+		result->heap_index = NOT_IN_HEAP;
+		return result;
+	}
+
+	/**
+	 * Restore the order of the heap after the priority of a node changed.
+	 * @param item The node, which has to be in the heap.
+	 */
+	void Update(Titem *item)
+	{
+		uint index = item->heap_index;
+		assert(index < this->items.size() && this->items[index] == item);
+
+		if (index > 0 && this->items[(index - 1) / Tarity]->priority >= item->priority) {
+			this->SiftUp(item, index);
+		} else {
+			this->SiftDown(item, index);
+		}
+	}
+
+	/** Remove all nodes from the heap, but keep its memory. */
+	inline void Clear()
+	{
+		this->items.clear();
+	}
+
+	/** Remove all nodes from the heap and release its memory. */
+	inline void Free()
+	{
+		this->items.clear();
+		this->items.shrink_to_fit();
+	}
 };
+
 /**
- * Generates a hash code from the given key pair. You should make sure that
- * the resulting range is clearly defined.
+ * Open addressing hash of nodes by their tile and trackdir.
+ * Nodes can not be removed one by one, only all at once by #Clear.
+ * @tparam Titem Type of the nodes; needs the methods \c GetTile() and \c GetDirection().
  */
-typedef uint Hash_HashProc(uint key1, uint key2);
-struct Hash {
-	/* The hash function used */
-	Hash_HashProc *hash;
-	/* The amount of items in the hash */
-	uint size;
-	/* The number of buckets allocated */
-	uint num_buckets;
-	/* A pointer to an array of num_buckets buckets. */
-	HashNode *buckets;
-	/* A pointer to an array of numbuckets booleans, which will be true if
-	 * there are any Nodes in the bucket */
-	bool *buckets_in_use;
-
-	void Init(Hash_HashProc *hash, uint num_buckets);
-
-	void *Get(uint key1, uint key2) const;
-	void *Set(uint key1, uint key2, void *value);
-
-	void *DeleteValue(uint key1, uint key2);
-
-	void Clear(bool free_values);
-	void Delete(bool free_values);
+template <class Titem>
+class NodeHash {
+	static const uint INITIAL_BITS = 10; ///< Number of bits of the initial number of slots.
+
+	/** A slot of the table; its key is stored too, so probing does not need to look at the nodes. */
+	struct Slot {
+		TileIndex tile;    ///< The tile of the node.
+		Trackdir direction; ///< The trackdir of the node.
+		Titem *item;       ///< The node, or \c nullptr if the slot is empty.
+	};
+
+	std::vector<Slot> slots; ///< The slots; their number is a power of two.
+	uint shift;              ///< Number of bits to drop from the 32 bits hash to get a slot index.
+	uint count;              ///< Number of nodes in the hash.
 
 	/**
-	 * Gets the current size of the hash.
+	 * Get the first slot to look at for a key.
+	 * @param tile The tile.
+	 * @param direction The trackdir.
+	 * @return The index of the slot.
+	 */
+	inline uint GetSlot(TileIndex tile, Trackdir direction) const
+	{
+		return ((tile << 4 | (direction & 0xF)) * 0x9E3779B1U) >> this->shift;
+	}
+
+	/**
+	 * Put a node in the first empty slot of its probe sequence.
+	 * @param item The node, not in the hash yet.
+	 */
+	void Place(Titem *item)
+	{
+		uint mask = (uint)this->slots.size() - 1;
+		uint i = this->GetSlot(item->GetTile(), item->GetDirection());
+		while (this->slots[i].item != nullptr) i = (i + 1) & mask;
+		this->slots[i] = { item->GetTile(), item->GetDirection(), item };
+	}
+
+	/** Double the number of slots. */
+	void Grow()
+	{
+		std::vector<Slot> old_slots(this->slots.size() * 2, Slot{ INVALID_TILE, INVALID_TRACKDIR, nullptr });
+		old_slots.swap(this->slots);
+		this->shift--;
+		for (const Slot &slot : old_slots) {
+			if (slot.item != nullptr) this->Place(slot.item);
+		}
+	}
+
+public:
+	NodeHash() : slots(1 << INITIAL_BITS, Slot{ INVALID_TILE, INVALID_TRACKDIR, nullptr }), shift(32 - INITIAL_BITS), count(0) {}
+
+	/**
+	 * Get the number of nodes in the hash.
+	 * @return The number of nodes.
 	 */
 	inline uint GetSize() const
 	{
-		return this->size;
+		return this->count;
+	}
+
+	/**
+	 * Find the node of a tile and trackdir.
+	 * @param tile The tile.
+	 * @param direction The trackdir.
+	 * @return The node, or \c nullptr if there is none.
+	 */
+	inline Titem *Find(TileIndex tile, Trackdir direction) const
+	{
+		uint mask = (uint)this->slots.size() - 1;
+		for (uint i = this->GetSlot(tile, direction);; i = (i + 1) & mask) {
+			const Slot &slot = this->slots[i];
+			if (slot.item == nullptr || (slot.tile == tile && slot.direction == direction)) return slot.item;
+		}
 	}
 
-protected:
-#ifdef HASH_STATS
-	void PrintStatistics() const;
-#endif
-	HashNode *FindNode(uint key1, uint key2, HashNode** prev_out) const;
+	/**
+	 * Add a node to the hash.
+	 * @param item The node; there must not be a node with the same tile and trackdir in the hash yet.
+	 */
+	void Insert(Titem *item)
+	{
+		/* Keep at least half of the slots empty, so probe sequences stay short. */
+		if ((this->count + 1) * 2 > this->slots.size()) this->Grow();
+		this->Place(item);
+		this->count++;
+	}
+
+	/** Remove all nodes from the hash, but keep its memory. */
+	void Clear()
+	{
+		if (this->count == 0) return;
+		std::fill(this->slots.begin(), this->slots.end(), Slot{ INVALID_TILE, INVALID_TRACKDIR, nullptr });
+		this->count = 0;
+	}
+
+	/** Remove all nodes from the hash and go back to the initial number of slots. */
+	void Free()
+	{
+		std::vector<Slot>(1 << INITIAL_BITS, Slot{ INVALID_TILE, INVALID_TRACKDIR, nullptr }).swap(this->slots);
+		this->shift = 32 - INITIAL_BITS;
+		this->count = 0;
+	}
 };
 
 #endif /* QUEUE_H */
@@ -0,0 +1,338 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.cpp Handles dividing the water in the map into square regions to assist pathfinding. */
+
+#include "../stdafx.h"
+#include "../map_func.h"
+#include "../ship.h"
+#include "../tunnelbridge_map.h"
+#include "../debug.h"
+#include "follow_track.hpp"
+#include "water_regions.h"
+
+#include "../safeguards.h"
+
+/**
+ * Get the number of water regions along the X axis of the map.
+ * @return The number of regions.
+ */
+static inline int GetWaterRegionMapSizeX()
+{
+	return MapSizeX() / WATER_REGION_EDGE_LENGTH;
+}
+
+/**
+ * Get the number of water regions along the Y axis of the map.
+ * @return The number of regions.
+ */
+static inline int GetWaterRegionMapSizeY()
+{
+	return MapSizeY() / WATER_REGION_EDGE_LENGTH;
+}
+
+/**
+ * Get the index of a water region in #_water_regions.
+ * @param tile A tile within the region.
+ * @return The index of the region.
+ */
+static inline uint GetWaterRegionIndex(TileIndex tile)
+{
+	return TileY(tile) / WATER_REGION_EDGE_LENGTH * GetWaterRegionMapSizeX() + TileX(tile) / WATER_REGION_EDGE_LENGTH;
+}
+
+/**
+ * The connectivity of the water tiles within one square region of the map.
+ * It is computed when it is first needed after the region was invalidated.
+ */
+class WaterRegion {
+	std::vector<TWaterRegionPatchLabel> tile_patch_labels; ///< Patch of each tile of the region, row by row; empty when the region contains no water.
+	uint16 edge_traversability_bits[DIAGDIR_END];          ///< Per side of the region, the edge tiles from which ships can cross that side.
+	bool has_cross_region_aqueducts;                       ///< Whether an aqueduct leads from this region into another one.
+	bool initialized;                                      ///< Whether the region has been computed since it was last invalidated.
+
+public:
+	WaterRegion() : initialized(false) {}
+
+	/**
+	 * Get the index of a tile within its region.
+	 * @param tile The tile.
+	 * @return Index of the tile in #tile_patch_labels.
+	 */
+	static inline uint GetLocalIndex(TileIndex tile)
+	{
+		return (TileX(tile) % WATER_REGION_EDGE_LENGTH) + (TileY(tile) % WATER_REGION_EDGE_LENGTH) * WATER_REGION_EDGE_LENGTH;
+	}
+
+	/**
+	 * Get the tile on an edge of a region.
+	 * @param x X coordinate of the region.
+	 * @param y Y coordinate of the region.
+	 * @param side The side of the region.
+	 * @param i Position of the tile along the edge.
+	 * @return The tile.
+	 */
+	static inline TileIndex GetEdgeTile(int x, int y, DiagDirection side, uint i)
+	{
+		static const uint LAST = WATER_REGION_EDGE_LENGTH - 1;
+		switch (side) {
+			case DIAGDIR_NE: return TileXY(x * WATER_REGION_EDGE_LENGTH,        y * WATER_REGION_EDGE_LENGTH + i);
+			case DIAGDIR_SE: return TileXY(x * WATER_REGION_EDGE_LENGTH + i,    y * WATER_REGION_EDGE_LENGTH + LAST);
+			case DIAGDIR_SW: return TileXY(x * WATER_REGION_EDGE_LENGTH + LAST, y * WATER_REGION_EDGE_LENGTH + i);
+			case DIAGDIR_NW: return TileXY(x * WATER_REGION_EDGE_LENGTH + i,    y * WATER_REGION_EDGE_LENGTH);
+			default: NOT_REACHED();
+		}
+	}
+
+	/**
+	 * Get the patch of water a tile of this region belongs to.
+	 * @param tile The tile.
+	 * @return The label of the patch, or #INVALID_WATER_REGION_PATCH if ships can not use the tile.
+	 */
+	inline TWaterRegionPatchLabel GetLabel(TileIndex tile) const
+	{
+		assert(this->initialized);
+		return this->tile_patch_labels.empty() ? INVALID_WATER_REGION_PATCH : this->tile_patch_labels[GetLocalIndex(tile)];
+	}
+
+	inline bool IsInitialized() const { return this->initialized; }
+	inline void Invalidate() { this->initialized = false; }
+	inline uint16 GetEdgeTraversabilityBits(DiagDirection side) const { return this->edge_traversability_bits[side]; }
+	inline bool HasCrossRegionAqueducts() const { return this->has_cross_region_aqueducts; }
+
+	bool operator==(const WaterRegion &other) const
+	{
+		return this->initialized == other.initialized && this->tile_patch_labels == other.tile_patch_labels &&
+				this->has_cross_region_aqueducts == other.has_cross_region_aqueducts &&
+				memcmp(this->edge_traversability_bits, other.edge_traversability_bits, sizeof(this->edge_traversability_bits)) == 0;
+	}
+
+	void Update(int x, int y);
+};
+
+static std::vector<WaterRegion> _water_regions; ///< The water regions of the map, row by row.
+
+/**
+ * Compute the patches of water of a region and which of its edge tiles lead into the adjacent regions.
+ * Tiles are put into the same patch when a ship can sail from one to the other without leaving the region.
+ * @param x X coordinate of the region.
+ * @param y Y coordinate of the region.
+ */
+void WaterRegion::Update(int x, int y)
+{
+	this->initialized = true;
+	this->has_cross_region_aqueducts = false;
+	this->tile_patch_labels.clear();
+	MemSetT(this->edge_traversability_bits, 0, lengthof(this->edge_traversability_bits));
+
+	const TileIndex north = TileXY(x * WATER_REGION_EDGE_LENGTH, y * WATER_REGION_EDGE_LENGTH);
+	const uint region_index = GetWaterRegionIndex(north);
+
+	TWaterRegionPatchLabel current_label = INVALID_WATER_REGION_PATCH;
+	std::vector<TileIndex> tiles_to_check;
+
+	for (uint i = 0; i < WATER_REGION_NUMBER_OF_TILES; i++) {
+		TileIndex start_tile = north + TileDiffXY(i % WATER_REGION_EDGE_LENGTH, i / WATER_REGION_EDGE_LENGTH);
+		if (!this->tile_patch_labels.empty() && this->tile_patch_labels[i] != INVALID_WATER_REGION_PATCH) continue;
+		if (TrackStatusToTrackdirBits(GetTileTrackStatus(start_tile, TRANSPORT_WATER, 0)) == TRACKDIR_BIT_NONE) continue;
+
+		if (this->tile_patch_labels.empty()) this->tile_patch_labels.resize(WATER_REGION_NUMBER_OF_TILES, INVALID_WATER_REGION_PATCH);
+
+		/* Regions with more patches than there are labels are not worth optimising for; the patches
+		 * that do not get a label of their own are treated as if they were connected to each other. */
+		if (current_label < UINT8_MAX) current_label++;
+
+		this->tile_patch_labels[i] = current_label;
+		tiles_to_check.push_back(start_tile);
+
+		while (!tiles_to_check.empty()) {
+			TileIndex tile = tiles_to_check.back();
+			tiles_to_check.pop_back();
+
+			TrackdirBits trackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0));
+			for (; trackdirs != TRACKDIR_BIT_NONE; trackdirs = KillFirstBit(trackdirs)) {
+				CFollowTrackWater ft;
+				if (!ft.Follow(tile, (Trackdir)FindFirstBit2x64(trackdirs))) continue;
+
+				if (GetWaterRegionIndex(ft.m_new_tile) != region_index) {
+					if (ft.m_is_bridge) {
+						/* The far end of the aqueduct is found when looking for the neighbours of the patch. */
+						this->has_cross_region_aqueducts = true;
+						continue;
+					}
+
+					/* Leaving the region over one of its edges. */
+					uint position = DiagDirToAxis(ft.m_exitdir) == AXIS_X ? TileY(tile) % WATER_REGION_EDGE_LENGTH : TileX(tile) % WATER_REGION_EDGE_LENGTH;
+					SetBit(this->edge_traversability_bits[ft.m_exitdir], position);
+					continue;
+				}
+
+				TWaterRegionPatchLabel &label = this->tile_patch_labels[GetLocalIndex(ft.m_new_tile)];
+				if (label == INVALID_WATER_REGION_PATCH) {
+					label = current_label;
+					tiles_to_check.push_back(ft.m_new_tile);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Get a water region, computing it first if it is not up to date.
+ * @param x X coordinate of the region.
+ * @param y Y coordinate of the region.
+ * @return The region.
+ */
+static const WaterRegion &GetUpdatedWaterRegion(int x, int y)
+{
+	WaterRegion &region = _water_regions[y * GetWaterRegionMapSizeX() + x];
+	if (!region.IsInitialized()) region.Update(x, y);
+	return region;
+}
+
+/**
+ * Calculate a hash value for a patch of water.
+ * @param water_region_patch The patch.
+ * @return The hash value.
+ */
+int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch)
+{
+	return (water_region_patch.y * GetWaterRegionMapSizeX() + water_region_patch.x) | (water_region_patch.label << 24);
+}
+
+/**
+ * Get the tile in the centre of the region of a patch of water.
+ * @param water_region_patch The patch.
+ * @return The centre tile; it is not necessarily part of the patch.
+ */
+TileIndex GetWaterRegionCenterTile(const WaterRegionPatchDesc &water_region_patch)
+{
+	return TileXY(water_region_patch.x * WATER_REGION_EDGE_LENGTH + WATER_REGION_EDGE_LENGTH / 2, water_region_patch.y * WATER_REGION_EDGE_LENGTH + WATER_REGION_EDGE_LENGTH / 2);
+}
+
+/**
+ * Get the patch of water a tile belongs to.
+ * @param tile The tile.
+ * @return The patch; its label is #INVALID_WATER_REGION_PATCH if ships can not use the tile.
+ */
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile)
+{
+	WaterRegionPatchDesc desc;
+	desc.x = TileX(tile) / WATER_REGION_EDGE_LENGTH;
+	desc.y = TileY(tile) / WATER_REGION_EDGE_LENGTH;
+	desc.label = GetUpdatedWaterRegion(desc.x, desc.y).GetLabel(tile);
+	return desc;
+}
+
+/**
+ * Add a patch of water to a list of patches, unless it is already in there.
+ * @param patches The list of patches.
+ * @param water_region_patch The patch to add.
+ */
+static void IncludeWaterRegionPatch(std::vector<WaterRegionPatchDesc> &patches, const WaterRegionPatchDesc &water_region_patch)
+{
+	if (std::find(patches.begin(), patches.end(), water_region_patch) == patches.end()) patches.push_back(water_region_patch);
+}
+
+/**
+ * Get the patches of water ships can sail to directly from a patch of water in another region.
+ * @param water_region_patch The patch to start from.
+ * @param[out] neighbours The neighbouring patches; the vector is cleared first.
+ */
+void GetWaterRegionPatchNeighbours(const WaterRegionPatchDesc &water_region_patch, std::vector<WaterRegionPatchDesc> &neighbours)
+{
+	neighbours.clear();
+
+	const WaterRegion &region = GetUpdatedWaterRegion(water_region_patch.x, water_region_patch.y);
+
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		uint16 traversability_bits = region.GetEdgeTraversabilityBits(side);
+		if (traversability_bits == 0) continue;
+
+		const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+		const int nx = water_region_patch.x + offset.x;
+		const int ny = water_region_patch.y + offset.y;
+		if (nx < 0 || ny < 0 || nx >= GetWaterRegionMapSizeX() || ny >= GetWaterRegionMapSizeY()) continue;
+
+		const WaterRegion &neighbour = GetUpdatedWaterRegion(nx, ny);
+		traversability_bits &= neighbour.GetEdgeTraversabilityBits(ReverseDiagDir(side));
+
+		for (; traversability_bits != 0; traversability_bits = KillFirstBit(traversability_bits)) {
+			TileIndex tile = WaterRegion::GetEdgeTile(water_region_patch.x, water_region_patch.y, side, FindFirstBit(traversability_bits));
+			if (region.GetLabel(tile) != water_region_patch.label) continue;
+
+			WaterRegionPatchDesc desc;
+			desc.x = nx;
+			desc.y = ny;
+			desc.label = neighbour.GetLabel(TileAddByDiagDir(tile, side));
+			IncludeWaterRegionPatch(neighbours, desc);
+		}
+	}
+
+	if (!region.HasCrossRegionAqueducts()) return;
+
+	const TileIndex north = TileXY(water_region_patch.x * WATER_REGION_EDGE_LENGTH, water_region_patch.y * WATER_REGION_EDGE_LENGTH);
+	for (uint i = 0; i < WATER_REGION_NUMBER_OF_TILES; i++) {
+		TileIndex tile = north + TileDiffXY(i % WATER_REGION_EDGE_LENGTH, i / WATER_REGION_EDGE_LENGTH);
+		if (!IsBridgeTile(tile) || GetTunnelBridgeTransportType(tile) != TRANSPORT_WATER) continue;
+		if (region.GetLabel(tile) != water_region_patch.label) continue;
+
+		WaterRegionPatchDesc desc = GetWaterRegionPatchInfo(GetOtherBridgeEnd(tile));
+		if (desc.x != water_region_patch.x || desc.y != water_region_patch.y) IncludeWaterRegionPatch(neighbours, desc);
+	}
+}
+
+/**
+ * Mark the water region of a tile as changed, so it gets computed again when it is needed.
+ * Call this whenever the water tracks of a tile may have changed.
+ * @param tile The changed tile.
+ */
+void InvalidateWaterRegion(TileIndex tile)
+{
+	if (_water_regions.empty()) return;
+
+	_water_regions[GetWaterRegionIndex(tile)].Invalidate();
+
+	/* Whether ships can cross the edge of a region depends on the first tile
+	 * of the adjacent region too, so those regions might have changed as well. */
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+		TileIndex adjacent = TileAddWrap(tile, offset.x, offset.y);
+		if (adjacent == INVALID_TILE) continue;
+		_water_regions[GetWaterRegionIndex(adjacent)].Invalidate();
+	}
+}
+
+/** Throw away all water regions, e.g. because a new map has been allocated or loaded. */
+void InitializeWaterRegions()
+{
+	_water_regions.clear();
+	_water_regions.resize(GetWaterRegionMapSizeX() * GetWaterRegionMapSizeY());
+}
+
+/**
+ * Compute all water regions that are in use again.
+ * @return True iff none of the regions changed, i.e. they were all up to date.
+ */
+bool RebuildWaterRegions()
+{
+	bool up_to_date = true;
+	for (int y = 0; y < GetWaterRegionMapSizeY(); y++) {
+		for (int x = 0; x < GetWaterRegionMapSizeX(); x++) {
+			WaterRegion &region = _water_regions[y * GetWaterRegionMapSizeX() + x];
+			if (!region.IsInitialized()) continue;
+
+			WaterRegion old_region = region;
+			region.Update(x, y);
+			if (!(region == old_region)) {
+				DEBUG(desync, 2, "water region mismatch: region %i,%i", x, y);
+				up_to_date = false;
+			}
+		}
+	}
+	return up_to_date;
+}
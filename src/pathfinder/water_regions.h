@@ -0,0 +1,44 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.h Handles dividing the water in the map into square regions to assist pathfinding. */
+
+#ifndef WATER_REGIONS_H
+#define WATER_REGIONS_H
+
+#include "../tile_type.h"
+#include <vector>
+
+typedef byte TWaterRegionPatchLabel; ///< Label of a patch of water within a water region.
+
+static const uint WATER_REGION_EDGE_LENGTH = 16; ///< Number of tiles along each edge of a water region.
+static const uint WATER_REGION_NUMBER_OF_TILES = WATER_REGION_EDGE_LENGTH * WATER_REGION_EDGE_LENGTH; ///< Number of tiles in a water region.
+static const TWaterRegionPatchLabel INVALID_WATER_REGION_PATCH = 0; ///< Label of tiles that are not part of any patch of water.
+
+/**
+ * Describes a single interconnected patch of water within a particular water region.
+ * The tiles of a patch are connected to each other without leaving the region.
+ */
+struct WaterRegionPatchDesc {
+	int x;                        ///< The X coordinate of the water region, i.e. X=2 is the 3rd water region along the X-axis.
+	int y;                        ///< The Y coordinate of the water region, i.e. Y=2 is the 3rd water region along the Y-axis.
+	TWaterRegionPatchLabel label; ///< Label identifying the patch within the region, or #INVALID_WATER_REGION_PATCH.
+
+	bool operator==(const WaterRegionPatchDesc &other) const { return this->x == other.x && this->y == other.y && this->label == other.label; }
+	bool operator!=(const WaterRegionPatchDesc &other) const { return !(*this == other); }
+};
+
+int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch);
+TileIndex GetWaterRegionCenterTile(const WaterRegionPatchDesc &water_region_patch);
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile);
+void GetWaterRegionPatchNeighbours(const WaterRegionPatchDesc &water_region_patch, std::vector<WaterRegionPatchDesc> &neighbours);
+
+void InvalidateWaterRegion(TileIndex tile);
+void InitializeWaterRegions();
+bool RebuildWaterRegions();
+
+#endif /* WATER_REGIONS_H */
@@ -13,6 +13,8 @@
 #include "../../misc/array.hpp"
 #include "../../misc/hashtable.hpp"
 #include "../../misc/binaryheap.hpp"
+#include <memory>
+#include <vector>
 
 /**
  * Hash table based node list multi-container class.
@@ -30,22 +32,73 @@ public:
 	typedef CBinaryHeapT<Titem_> CPriorityQueue;                 ///< How the priority queue will be managed.
 
 protected:
-	CItemArray      m_arr;        ///< Here we store full item data (Titem_).
-	COpenList       m_open;       ///< Hash table of pointers to open item data.
-	CClosedList     m_closed;     ///< Hash table of pointers to closed item data.
-	CPriorityQueue  m_open_queue; ///< Priority queue of pointers to open item data.
-	Titem          *m_new_node;   ///< New open node under construction.
+	/**
+	 * The containers of a node list. They are kept by the thread after the
+	 * search, so the next search of the same kind can reuse their memory.
+	 */
+	struct Storage {
+		CItemArray      arr;         ///< Here we store full item data (Titem_).
+		COpenList       open;        ///< Hash table of pointers to open item data.
+		CClosedList     closed;      ///< Hash table of pointers to closed item data.
+		CPriorityQueue  open_queue;  ///< Priority queue of pointers to open item data.
+		int             allocations; ///< Number of memory blocks allocated for the current search.
+
+		Storage() : open_queue(2048), allocations(3) {}
+
+		/** Forget all items; the hash tables are cleared without touching their slots. */
+		void Clear()
+		{
+			this->arr.Clear();
+			this->open.Clear();
+			this->closed.Clear();
+			this->open_queue.Clear();
+			this->allocations = 0;
+		}
+	};
+
+	/** The containers not used by any node list of this thread. */
+	static std::vector<std::unique_ptr<Storage>> &FreeStorage()
+	{
+		static thread_local std::vector<std::unique_ptr<Storage>> free_storage;
+		return free_storage;
+	}
+
+	/** Take containers from the free ones, or allocate new ones when there are none. */
+	static std::unique_ptr<Storage> AcquireStorage()
+	{
+		std::vector<std::unique_ptr<Storage>> &free_storage = FreeStorage();
+		if (free_storage.empty()) return std::make_unique<Storage>();
+
+		std::unique_ptr<Storage> storage = std::move(free_storage.back());
+		free_storage.pop_back();
+		return storage;
+	}
+
+	std::unique_ptr<Storage> m_storage; ///< Containers used by this node list.
+	CItemArray     &m_arr;              ///< Here we store full item data (Titem_).
+	COpenList      &m_open;             ///< Hash table of pointers to open item data.
+	CClosedList    &m_closed;           ///< Hash table of pointers to closed item data.
+	CPriorityQueue &m_open_queue;       ///< Priority queue of pointers to open item data.
+	Titem          *m_new_node;         ///< New open node under construction.
 
 public:
 	/** default constructor */
-	CNodeList_HashTableT() : m_open_queue(2048)
+	CNodeList_HashTableT() : m_storage(AcquireStorage()), m_arr(m_storage->arr), m_open(m_storage->open), m_closed(m_storage->closed), m_open_queue(m_storage->open_queue)
 	{
 		m_new_node = nullptr;
 	}
 
-	/** destructor */
+	/** destructor; hands the containers back for the next search */
 	~CNodeList_HashTableT()
 	{
+		m_storage->Clear();
+		FreeStorage().push_back(std::move(m_storage));
+	}
+
+	/** return number of memory blocks allocated by this node list, i.e. not reused from earlier searches */
+	inline int AllocationCount() const
+	{
+		return m_storage->allocations;
 	}
 
 	/** return number of open nodes */
@@ -63,7 +116,10 @@ public:
 	/** allocate new data item from m_arr */
 	inline Titem_ *CreateNewNode()
 	{
-		if (m_new_node == nullptr) m_new_node = m_arr.AppendC();
+		if (m_new_node == nullptr) {
+			if (m_arr.NeedsSubArray()) m_storage->allocations++;
+			m_new_node = m_arr.AppendC();
+		}
 		return m_new_node;
 	}
 
@@ -82,6 +138,7 @@ public:
 	{
 		assert(m_closed.Find(item.GetKey()) == nullptr);
 		m_open.Push(item);
+		if (m_open_queue.IsFull()) m_storage->allocations++;
 		m_open_queue.Include(&item);
 		if (&item == m_new_node) {
 			m_new_node = nullptr;
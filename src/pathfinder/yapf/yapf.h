@@ -69,6 +69,12 @@ Track YapfTrainChooseTrack(const Train *v, TileIndex tile, DiagDirection enterdi
  */
 FindDepotData YapfRoadVehicleFindNearestDepot(const RoadVehicle *v, int max_penalty);
 
+/**
+ * Check whether the road vehicle path search results that may still be reused match new searches.
+ * @return True if they match.
+ */
+bool YapfCheckRoadPathCache();
+
 /**
  * Used when user sends train to the nearest depot or if train needs servicing using YAPF.
  * @param v            train that needs to go to some depot
@@ -11,12 +11,45 @@
 #define YAPF_CACHE_H
 
 #include "../../track_type.h"
+#include "../../station_type.h"
+#include "../../date_type.h"
+
+extern Date _yapf_road_layout_change_date;
 
 /**
- * Use this function to notify YAPF that track layout (or signal configuration) has change.
+ * Use this function to notify YAPF that track layout has changed, i.e. that a piece of track was built or removed.
  * @param tile  the tile that is changed
  * @param track what piece of track is changed
  */
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track);
 
+/**
+ * Use this function to notify YAPF that the costs of a piece of track may have
+ * changed without changing the track layout, e.g. by signals or rail type conversion.
+ * @param tile  the tile that is changed
+ * @param track what piece of track is changed
+ */
+void YapfNotifyTrackCostChange(TileIndex tile, Track track);
+
+/**
+ * Use this function to notify YAPF that road or tramway layout has changed.
+ * @param tile the tile that is changed
+ */
+void YapfNotifyRoadLayoutChange(TileIndex tile);
+
+/**
+ * Use this function to notify YAPF that the routes of road vehicles over a tile
+ * may have changed without changing the road layout, e.g. by one-way roads,
+ * road works, level crossings, road type conversion or terraforming.
+ * @param tile the tile that is changed, or INVALID_TILE for all tiles
+ */
+void YapfNotifyRoadCostChange(TileIndex tile);
+
+/**
+ * Use this function to notify YAPF that a road stop was built or removed.
+ * @param tile    the tile of the road stop
+ * @param station the station the road stop belongs to
+ */
+void YapfNotifyRoadStopChange(TileIndex tile, StationID station);
+
 #endif /* YAPF_CACHE_H */
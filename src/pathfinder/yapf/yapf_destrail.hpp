@@ -118,6 +118,8 @@ protected:
 	TileIndex    m_destTile;
 	TrackdirBits m_destTrackdirs;
 	StationID    m_dest_station_id;
+	const YapfLandmarks *m_landmarks = nullptr; ///< landmark distances of the rail network, if they are used
+	YapfLandmarkTarget   m_landmark_target;     ///< edges of the destination tiles for the landmark estimate
 
 	/** to access inherited path finder */
 	Tpf& Yapf()
@@ -153,6 +155,21 @@ public:
 				break;
 		}
 		CYapfDestinationRailBase::SetDestination(v);
+
+		if (Yapf().PfGetSettings().use_landmarks) {
+			m_landmarks = &YapfLandmarks::Get(TRANSPORT_RAIL);
+			m_landmark_target.Clear();
+			if (m_dest_station_id != INVALID_STATION) {
+				const BaseStation *st = BaseStation::Get(m_dest_station_id);
+				TileArea ta;
+				st->GetTileArea(&ta, v->current_order.IsType(OT_GOTO_STATION) ? STATION_RAIL : STATION_WAYPOINT);
+				for (TileIndex tile : ta) {
+					if (st->TileBelongsToRailStation(tile)) m_landmarks->AddTargetTile(m_landmark_target, tile);
+				}
+			} else {
+				m_landmarks->AddTargetTile(m_landmark_target, m_destTile);
+			}
+		}
 	}
 
 	/** Called by YAPF to detect if node ends in the desired destination */
@@ -197,6 +214,7 @@ public:
 		int dmin = std::min(dx, dy);
 		int dxy = abs(dx - dy);
 		int d = dmin * YAPF_TILE_CORNER_LENGTH + (dxy - 1) * (YAPF_TILE_LENGTH / 2);
+		if (m_landmarks != nullptr) d = std::max(d, m_landmarks->GetEstimate(m_landmark_target, tile, exitdir));
 		n.m_estimate = n.m_cost + d;
 		assert(n.m_estimate >= n.m_parent->m_estimate);
 		return true;
@@ -0,0 +1,360 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_landmarks.cpp Landmark based lower bounds for the cost estimates of YAPF. */
+
+#include "../../stdafx.h"
+#include "../../debug.h"
+#include "../../map_func.h"
+#include "../../landscape.h"
+#include "../../road_map.h"
+#include "../../track_func.h"
+#include "../../tunnelbridge.h"
+#include "../../tunnelbridge_map.h"
+#include "../pathfinder_type.h"
+#include "yapf_landmarks.h"
+
+#include <queue>
+#include <chrono>
+
+#include "../../safeguards.h"
+
+static YapfLandmarks _rail_landmarks(TRANSPORT_RAIL); ///< Landmark distances of the rail network.
+static YapfLandmarks _road_landmarks(TRANSPORT_ROAD); ///< Landmark distances of the road and tram network.
+
+/**
+ * Get the landmark distances of a network, whether they are up to date or not.
+ * @param transport_type The network, either #TRANSPORT_RAIL or #TRANSPORT_ROAD.
+ * @return The landmark distances.
+ */
+static YapfLandmarks &GetLandmarks(TransportType transport_type)
+{
+	assert(transport_type == TRANSPORT_RAIL || transport_type == TRANSPORT_ROAD);
+	return transport_type == TRANSPORT_RAIL ? _rail_landmarks : _road_landmarks;
+}
+
+/**
+ * Get the pieces of road or tramway that connect the edges of a normal road tile.
+ * All road bits of the tile are connected with each other, and a lone road bit
+ * with the opposite edge, even if road works or one way roads block them for now.
+ * @param bits The road bits of one road or tram type on the tile.
+ * @return The tracks connecting the edges.
+ */
+static TrackBits RoadBitsToNetworkTrackBits(RoadBits bits)
+{
+	if (CountBits(bits) == 1) return (bits & ROAD_X) != ROAD_NONE ? TRACK_BIT_X : TRACK_BIT_Y;
+
+	TrackBits tracks = TRACK_BIT_NONE;
+	if ((bits & ROAD_X) == ROAD_X) tracks |= TRACK_BIT_X;
+	if ((bits & ROAD_Y) == ROAD_Y) tracks |= TRACK_BIT_Y;
+	if ((bits & ROAD_N) == ROAD_N) tracks |= TRACK_BIT_UPPER;
+	if ((bits & ROAD_S) == ROAD_S) tracks |= TRACK_BIT_LOWER;
+	if ((bits & ROAD_W) == ROAD_W) tracks |= TRACK_BIT_LEFT;
+	if ((bits & ROAD_E) == ROAD_E) tracks |= TRACK_BIT_RIGHT;
+	return tracks;
+}
+
+/**
+ * Get the pieces of track of a network on a tile.
+ * @param tile The tile.
+ * @param transport_type The network, either #TRANSPORT_RAIL or #TRANSPORT_ROAD.
+ * @return The tracks on the tile, regardless of their owner, type or signals.
+ */
+static TrackBits GetNetworkTrackBits(TileIndex tile, TransportType transport_type)
+{
+	if (transport_type == TRANSPORT_RAIL) return TrackStatusToTrackBits(GetTileTrackStatus(tile, TRANSPORT_RAIL, 0));
+
+	if (IsNormalRoadTile(tile)) {
+		return RoadBitsToNetworkTrackBits(GetRoadBits(tile, RTT_ROAD)) | RoadBitsToNetworkTrackBits(GetRoadBits(tile, RTT_TRAM));
+	}
+	return TrackStatusToTrackBits(GetTileTrackStatus(tile, TRANSPORT_ROAD, RTT_ROAD) | GetTileTrackStatus(tile, TRANSPORT_ROAD, RTT_TRAM));
+}
+
+/**
+ * Get the key of a tile edge in #nodes.
+ * The key is the position of the middle of the edge in half tiles.
+ * @param tile A tile next to the edge.
+ * @param side The side of \a tile the edge is at.
+ * @return The key of the edge.
+ */
+/* static */ uint32 YapfLandmarks::GetEdgeKey(TileIndex tile, DiagDirection side)
+{
+	static const int side_to_x_offs[] = {-1, 0, 1, 0};
+	static const int side_to_y_offs[] = {0, 1, 0, -1};
+	uint32 x = 2 * TileX(tile) + side_to_x_offs[side];
+	uint32 y = 2 * TileY(tile) + side_to_y_offs[side];
+	return y * 2 * MapSizeX() + x;
+}
+
+/**
+ * Get the node of a tile edge, adding it to the graph if it is not there yet.
+ * @param tile A tile next to the edge.
+ * @param side The side of \a tile the edge is at.
+ * @return The index of the node.
+ */
+uint32 YapfLandmarks::GetNode(TileIndex tile, DiagDirection side)
+{
+	return this->nodes.emplace(GetEdgeKey(tile, side), (uint32)this->nodes.size()).first->second;
+}
+
+/**
+ * Find the shortest distances from one node to all nodes of its component.
+ * @param source The node to start at.
+ * @param[in,out] distances Per node, the distance; must be UINT32_MAX for all nodes of the component of \a source.
+ */
+void YapfLandmarks::FindDistances(uint32 source, std::vector<uint32> &distances) const
+{
+	typedef std::pair<uint32, uint32> QueueItem; // distance, node
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+	distances[source] = 0;
+	queue.emplace(0, source);
+	while (!queue.empty()) {
+		QueueItem item = queue.top();
+		queue.pop();
+		if (item.first != distances[item.second]) continue;
+
+		for (uint32 i = this->edge_begin[item.second]; i < this->edge_begin[item.second + 1]; i++) {
+			const Edge &edge = this->edges[i];
+			uint32 distance = item.first + edge.cost;
+			if (distance < distances[edge.to]) {
+				distances[edge.to] = distance;
+				queue.emplace(distance, edge.to);
+			}
+		}
+	}
+}
+
+/**
+ * Build the graph of the network and compute the distances to the landmarks.
+ * The landmarks of each component are chosen one by one as the node farthest
+ * away from all landmarks chosen so far, starting with the node farthest away
+ * from an arbitrary node.
+ */
+void YapfLandmarks::Build()
+{
+	struct Connection {
+		uint32 from; ///< Node the connection starts at.
+		Edge edge;   ///< Where the connection leads to.
+	};
+	std::vector<Connection> connections;
+	auto connect = [&connections](uint32 a, uint32 b, uint32 cost) {
+		connections.push_back({a, {b, cost}});
+		connections.push_back({b, {a, cost}});
+	};
+
+	this->nodes.clear();
+	for (TileIndex tile = 0; tile < MapSize(); tile++) {
+		TrackBits tracks = GetNetworkTrackBits(tile, this->transport_type);
+		if (tracks == TRACK_BIT_NONE) continue;
+
+		Track track;
+		FOR_EACH_SET_TRACK(track, tracks) {
+			Trackdir td = TrackToTrackdir(track);
+			uint32 cost = IsDiagonalTrack(track) ? YAPF_TILE_LENGTH : YAPF_TILE_CORNER_LENGTH;
+			connect(this->GetNode(tile, TrackdirToExitdir(td)), this->GetNode(tile, TrackdirToExitdir(ReverseTrackdir(td))), cost);
+		}
+
+		if (IsTileType(tile, MP_TUNNELBRIDGE)) {
+			/* Connect the inner edges of both ends; the tiles in between cost their base cost. */
+			TileIndex other_end = GetOtherTunnelBridgeEnd(tile);
+			if (tile < other_end) {
+				DiagDirection dir = GetTunnelBridgeDirection(tile);
+				connect(this->GetNode(tile, dir), this->GetNode(other_end, ReverseDiagDir(dir)), YAPF_TILE_LENGTH * GetTunnelBridgeLength(tile, other_end));
+			}
+		}
+	}
+
+	uint32 num_nodes = (uint32)this->nodes.size();
+	this->edge_begin.assign(num_nodes + 1, 0);
+	for (const Connection &c : connections) this->edge_begin[c.from + 1]++;
+	for (uint32 i = 0; i < num_nodes; i++) this->edge_begin[i + 1] += this->edge_begin[i];
+	this->edges.resize(connections.size());
+	std::vector<uint32> next_edge(this->edge_begin.begin(), this->edge_begin.end() - 1);
+	for (const Connection &c : connections) this->edges[next_edge[c.from]++] = c.edge;
+
+	this->node_component.assign(num_nodes, UINT32_MAX);
+	this->node_distances.assign(num_nodes * YAPF_LANDMARKS_PER_COMPONENT, UINT32_MAX);
+
+	std::vector<uint32> distances(num_nodes, UINT32_MAX);
+	std::vector<uint32> nearest_landmark(num_nodes, UINT32_MAX);
+	std::vector<uint32> component_nodes;
+	uint32 num_components = 0;
+	for (uint32 start = 0; start < num_nodes; start++) {
+		if (this->node_component[start] != UINT32_MAX) continue;
+
+		/* Collect the nodes of the component. */
+		uint32 component = num_components++;
+		component_nodes.clear();
+		component_nodes.push_back(start);
+		this->node_component[start] = component;
+		for (size_t i = 0; i < component_nodes.size(); i++) {
+			uint32 node = component_nodes[i];
+			for (uint32 e = this->edge_begin[node]; e < this->edge_begin[node + 1]; e++) {
+				uint32 to = this->edges[e].to;
+				if (this->node_component[to] != UINT32_MAX) continue;
+				this->node_component[to] = component;
+				component_nodes.push_back(to);
+			}
+		}
+
+		/* Choose the landmarks and store the distances to them. */
+		uint32 landmark = start;
+		for (uint i = 0; i <= YAPF_LANDMARKS_PER_COMPONENT; i++) {
+			for (uint32 node : component_nodes) distances[node] = UINT32_MAX;
+			this->FindDistances(landmark, distances);
+
+			/* The first search only finds the first landmark, the others are from the landmarks. */
+			uint32 farthest_distance = 0;
+			for (uint32 node : component_nodes) {
+				if (i == 0) {
+					nearest_landmark[node] = distances[node];
+				} else {
+					this->node_distances[node * YAPF_LANDMARKS_PER_COMPONENT + i - 1] = distances[node];
+					nearest_landmark[node] = (i == 1) ? distances[node] : std::min(nearest_landmark[node], distances[node]);
+				}
+				if (nearest_landmark[node] > farthest_distance) {
+					farthest_distance = nearest_landmark[node];
+					landmark = node;
+				}
+			}
+			if (farthest_distance == 0) break;
+		}
+	}
+
+	DEBUG(yapf, 3, "[YAPF%c] Landmark distances computed for %u tile edges in %u networks", this->transport_type == TRANSPORT_RAIL ? 'T' : 'R', num_nodes, num_components);
+	this->valid = true;
+}
+
+bool YapfLandmarks::operator==(const YapfLandmarks &other) const
+{
+	return this->nodes == other.nodes && this->node_component == other.node_component && this->node_distances == other.node_distances;
+}
+
+/**
+ * Add the edges of a tile to the edges a vehicle can reach its destination through.
+ * @param target The target to extend.
+ * @param tile The tile the vehicle can end its route on.
+ */
+void YapfLandmarks::AddTargetTile(YapfLandmarkTarget &target, TileIndex tile) const
+{
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		auto it = this->nodes.find(GetEdgeKey(tile, side));
+		if (it == this->nodes.end()) continue;
+
+		uint32 node = it->second;
+		uint32 component = this->node_component[node];
+		auto part = std::find_if(target.parts.begin(), target.parts.end(), [component](const YapfLandmarkTarget::Part &p) { return p.component == component; });
+		if (part == target.parts.end()) {
+			part = target.parts.emplace(target.parts.end());
+			part->component = component;
+			std::fill(std::begin(part->min_distance), std::end(part->min_distance), UINT32_MAX);
+			std::fill(std::begin(part->max_distance), std::end(part->max_distance), 0);
+		}
+
+		const uint32 *distances = &this->node_distances[node * YAPF_LANDMARKS_PER_COMPONENT];
+		for (uint i = 0; i < YAPF_LANDMARKS_PER_COMPONENT; i++) {
+			if (distances[i] == UINT32_MAX) break;
+			part->min_distance[i] = std::min(part->min_distance[i], distances[i]);
+			part->max_distance[i] = std::max(part->max_distance[i], distances[i]);
+		}
+	}
+}
+
+/**
+ * Get a lower bound of the cost of driving from a tile edge to the target.
+ * @param target The edges the vehicle can reach its destination through.
+ * @param tile The tile the vehicle is leaving.
+ * @param exitdir The side of the tile the vehicle leaves it through.
+ * @return The lower bound, or 0 when nothing is known about the cost.
+ */
+int YapfLandmarks::GetEstimate(const YapfLandmarkTarget &target, TileIndex tile, DiagDirection exitdir) const
+{
+	if (target.parts.empty()) return 0;
+
+	auto it = this->nodes.find(GetEdgeKey(tile, exitdir));
+	if (it == this->nodes.end()) return 0;
+
+	uint32 node = it->second;
+	uint32 component = this->node_component[node];
+	for (const YapfLandmarkTarget::Part &part : target.parts) {
+		if (part.component != component) continue;
+
+		const uint32 *distances = &this->node_distances[node * YAPF_LANDMARKS_PER_COMPONENT];
+		uint32 estimate = 0;
+		for (uint i = 0; i < YAPF_LANDMARKS_PER_COMPONENT; i++) {
+			if (distances[i] == UINT32_MAX) break;
+			if (part.min_distance[i] > distances[i]) estimate = std::max(estimate, part.min_distance[i] - distances[i]);
+			if (distances[i] > part.max_distance[i]) estimate = std::max(estimate, distances[i] - part.max_distance[i]);
+		}
+		return (int)estimate;
+	}
+	return 0;
+}
+
+/**
+ * Get the landmark distances of a network, recomputing them if the network has changed.
+ * @param transport_type The network, either #TRANSPORT_RAIL or #TRANSPORT_ROAD.
+ * @return The up to date landmark distances.
+ */
+/* static */ const YapfLandmarks &YapfLandmarks::Get(TransportType transport_type)
+{
+	YapfLandmarks &landmarks = GetLandmarks(transport_type);
+	if (landmarks.valid) return landmarks;
+
+	static std::chrono::steady_clock::duration total_build_time[2]; // per network, the time spent on rebuilding the distances so far
+	auto start_time = std::chrono::steady_clock::now();
+
+	/* Not every layout change changes the distances, e.g. when a piece of track was built and removed again. */
+	YapfLandmarks current(transport_type);
+	current.Build();
+	bool changed = !(current == landmarks);
+	if (changed) {
+		current.version = landmarks.version + 1;
+		landmarks = std::move(current);
+	} else {
+		landmarks.valid = true;
+	}
+
+	if (_debug_yapf_level >= 2) {
+		auto build_time = std::chrono::steady_clock::now() - start_time;
+		auto &total_time = total_build_time[transport_type == TRANSPORT_RAIL ? 0 : 1];
+		total_time += build_time;
+		DEBUG(yapf, 2, "[YAPF%c] Landmark distances rebuilt for %u tile edges%s - %d us - %d us in total",
+			transport_type == TRANSPORT_RAIL ? 'T' : 'R', (uint)landmarks.nodes.size(), changed ? "" : " (unchanged)",
+			(int)std::chrono::duration_cast<std::chrono::microseconds>(build_time).count(),
+			(int)std::chrono::duration_cast<std::chrono::microseconds>(total_time).count());
+	}
+	return landmarks;
+}
+
+/**
+ * Check whether the landmark distances that are considered up to date match the map.
+ * @return True if all of them match.
+ */
+/* static */ bool YapfLandmarks::Check()
+{
+	bool match = true;
+	for (TransportType transport_type : { TRANSPORT_RAIL, TRANSPORT_ROAD }) {
+		const YapfLandmarks &landmarks = GetLandmarks(transport_type);
+		if (!landmarks.valid) continue;
+
+		YapfLandmarks current(transport_type);
+		current.Build();
+		if (!(current == landmarks)) match = false;
+	}
+	return match;
+}
+
+/**
+ * Mark the landmark distances of a network as outdated.
+ * @param transport_type The network, either #TRANSPORT_RAIL or #TRANSPORT_ROAD.
+ */
+void InvalidateYapfLandmarks(TransportType transport_type)
+{
+	GetLandmarks(transport_type).Invalidate();
+}
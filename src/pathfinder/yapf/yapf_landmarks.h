@@ -0,0 +1,103 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_landmarks.h Landmark based lower bounds for the cost estimates of YAPF. */
+
+#ifndef YAPF_LANDMARKS_H
+#define YAPF_LANDMARKS_H
+
+#include "../../tile_type.h"
+#include "../../direction_type.h"
+#include "../../transport_type.h"
+#include <vector>
+#include <unordered_map>
+
+static const uint YAPF_LANDMARKS_PER_COMPONENT = 8; ///< Maximum number of landmarks chosen in each connected part of a network.
+
+/**
+ * The distances from the landmarks to the tile edges a vehicle can reach its destination through.
+ * Filled by #YapfLandmarks::AddTargetTile and used by #YapfLandmarks::GetEstimate.
+ */
+class YapfLandmarkTarget {
+	friend class YapfLandmarks;
+
+	/** The target edges lying in one connected part of the network. */
+	struct Part {
+		uint32 component;                                 ///< The connected part of the network.
+		uint32 min_distance[YAPF_LANDMARKS_PER_COMPONENT]; ///< Per landmark, the distance to the nearest target edge.
+		uint32 max_distance[YAPF_LANDMARKS_PER_COMPONENT]; ///< Per landmark, the distance to the farthest target edge.
+	};
+
+	std::vector<Part> parts; ///< The parts of the network containing target edges.
+
+public:
+	/** Forget all target edges. */
+	void Clear() { this->parts.clear(); }
+};
+
+/**
+ * Shortest distances from a few landmark tile edges to all tile edges of the rail or road network.
+ *
+ * The network is a graph of the tile edges crossed by a track, with the pieces
+ * of track as connections. A connection costs no more than YAPF charges for
+ * driving along it, whatever the owner, rail or road type and signals are. Hence
+ * by the triangle inequality the difference between the distances of two edges
+ * to any landmark is a lower bound of the cost of driving between them, which can
+ * be combined with the distance estimate without making it inconsistent.
+ *
+ * The distances are recomputed when they are first needed after a piece of
+ * track was built or removed, so they only depend on the map. Changes that do
+ * not add or remove connections, like signals or rail type conversion, keep them.
+ * Road vehicles do not use them on a day the road network changed on, so town
+ * growth does not make them recompute the distances more than once a day.
+ */
+class YapfLandmarks {
+	TransportType transport_type;                ///< The network the distances are computed for.
+	bool valid;                                  ///< Whether the distances match the current layout of the network.
+	uint32 version;                              ///< Incremented whenever recomputing the distances changed them.
+
+	std::unordered_map<uint32, uint32> nodes;    ///< Node index of each tile edge, see #GetEdgeKey.
+	std::vector<uint32> node_component;          ///< Per node, the connected part of the network it belongs to.
+	std::vector<uint32> node_distances;          ///< Per node, the distances to the landmarks of its component; UINT32_MAX if there is no such landmark.
+
+	struct Edge {
+		uint32 to;   ///< Node the edge leads to.
+		uint32 cost; ///< Lower bound of the cost of driving along the edge.
+	};
+	std::vector<uint32> edge_begin;              ///< Per node, the index of its first edge in #edges; one extra entry marks the end.
+	std::vector<Edge> edges;                     ///< Edges of all nodes, sorted by node.
+
+	static uint32 GetEdgeKey(TileIndex tile, DiagDirection side);
+	uint32 GetNode(TileIndex tile, DiagDirection side);
+	void Build();
+	void FindDistances(uint32 source, std::vector<uint32> &distances) const;
+
+public:
+	YapfLandmarks(TransportType transport_type) : transport_type(transport_type), valid(false), version(0) {}
+
+	/** Mark the distances as outdated, e.g. because a piece of track was built or removed. */
+	void Invalidate() { this->valid = false; }
+
+	/**
+	 * Get the number of times recomputing the distances changed them.
+	 * Results depending on the estimates have to be forgotten when it changes.
+	 * @return The version of the distances.
+	 */
+	uint32 GetVersion() const { return this->version; }
+
+	bool operator==(const YapfLandmarks &other) const;
+
+	void AddTargetTile(YapfLandmarkTarget &target, TileIndex tile) const;
+	int GetEstimate(const YapfLandmarkTarget &target, TileIndex tile, DiagDirection exitdir) const;
+
+	static const YapfLandmarks &Get(TransportType transport_type);
+	static bool Check();
+};
+
+void InvalidateYapfLandmarks(TransportType transport_type);
+
+#endif /* YAPF_LANDMARKS_H */
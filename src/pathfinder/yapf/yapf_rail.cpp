@@ -13,6 +13,7 @@
 #include "yapf_cache.h"
 #include "yapf_node_rail.hpp"
 #include "yapf_costrail.hpp"
+#include "yapf_landmarks.h"
 #include "yapf_destrail.hpp"
 #include "../../viewport_func.h"
 #include "../../newgrf_station.h"
@@ -178,7 +179,7 @@ public:
 		if (target != nullptr) target->okay = true;
 
 		if (Yapf().CanUseGlobalCache(*m_res_node)) {
-			YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+			YapfNotifyTrackCostChange(INVALID_TILE, INVALID_TRACK);
 		}
 
 		return true;
@@ -638,6 +639,12 @@ bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, b
 int CSegmentCostCacheBase::s_rail_change_counter = 0;
 
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
+{
+	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
+	InvalidateYapfLandmarks(TRANSPORT_RAIL);
+}
+
+void YapfNotifyTrackCostChange(TileIndex tile, Track track)
 {
 	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
 }
@@ -10,10 +10,65 @@
 #include "../../stdafx.h"
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
+#include "yapf_cache.h"
+#include "yapf_landmarks.h"
 #include "../../roadstop_base.h"
+#include "../../date_func.h"
 
 #include "../../safeguards.h"
 
+Date _yapf_road_layout_change_date = INVALID_DATE; ///< The day the road network last started to change on, see #YapfNotifyRoadLayoutChange.
+
+/**
+ * Check whether the landmark estimates of the road network are used today.
+ * They are not used for the rest of the day the road network started to
+ * change on, so the distances are recomputed at most once a day.
+ * @return True if the landmark distances may be used.
+ */
+static bool RoadLandmarksUsable()
+{
+	return _date > _yapf_road_layout_change_date;
+}
+
+/** What the result of a road vehicle's path search depends on, besides the vehicle and its destination. */
+struct YapfRoadPathRecord {
+	/** The cost of a road stop tile as it was when searching. */
+	struct StopCost {
+		TileIndex tile;     ///< The road stop tile.
+		Trackdir trackdir;  ///< The trackdir the stop was passed with.
+		int cost;           ///< The cost of the stop at that time.
+	};
+
+	TileArea area;                    ///< The tiles whose costs were calculated.
+	std::vector<StopCost> stop_costs; ///< The costs of the road stops that were passed.
+};
+
+/**
+ * The penalty for passing a road stop, which depends on how many vehicles are using the stop.
+ * @param tile The road stop tile.
+ * @param trackdir The trackdir of the vehicle on the tile.
+ * @param settings The pathfinder settings.
+ * @return The penalty.
+ */
+static int RoadStopCost(TileIndex tile, Trackdir trackdir, const YAPFSettings &settings)
+{
+	const RoadStop *rs = RoadStop::GetByTile(tile, GetRoadStopType(tile));
+	if (IsDriveThroughStopTile(tile)) {
+		/* Increase the cost for drive-through road stops */
+		int cost = settings.road_stop_penalty;
+		DiagDirection dir = TrackdirToExitdir(trackdir);
+		if (!RoadStop::IsDriveThroughRoadStopContinuation(tile, tile - TileOffsByDiagDir(dir))) {
+			/* When we're the first road stop in a 'queue' of them we increase
+			 * cost based on the fill percentage of the whole queue. */
+			const RoadStop::Entry *entry = rs->GetEntry(dir);
+			cost += entry->GetOccupied() * settings.road_stop_occupied_penalty / entry->GetLength();
+		}
+		return cost;
+	}
+
+	/* Increase cost for filled road stops */
+	return settings.road_stop_bay_occupied_penalty * (!rs->IsFreeBay(0) + !rs->IsFreeBay(1)) / 2;
+}
 
 template <class Types>
 class CYapfCostRoadT
@@ -26,8 +81,9 @@ public:
 
 protected:
 	int m_max_cost;
+	YapfRoadPathRecord *m_record; ///< Where to record what the result depends on, if anywhere.
 
-	CYapfCostRoadT() : m_max_cost(0) {};
+	CYapfCostRoadT() : m_max_cost(0), m_record(nullptr) {};
 
 	/** to access inherited path finder */
 	Tpf& Yapf()
@@ -58,6 +114,7 @@ protected:
 	inline int OneTileCost(TileIndex tile, Trackdir trackdir)
 	{
 		int cost = 0;
+		if (m_record != nullptr) m_record->area.Add(tile);
 		/* set base cost */
 		if (IsDiagonalTrackdir(trackdir)) {
 			cost += YAPF_TILE_LENGTH;
@@ -70,21 +127,9 @@ protected:
 					break;
 
 				case MP_STATION: {
-					const RoadStop *rs = RoadStop::GetByTile(tile, GetRoadStopType(tile));
-					if (IsDriveThroughStopTile(tile)) {
-						/* Increase the cost for drive-through road stops */
-						cost += Yapf().PfGetSettings().road_stop_penalty;
-						DiagDirection dir = TrackdirToExitdir(trackdir);
-						if (!RoadStop::IsDriveThroughRoadStopContinuation(tile, tile - TileOffsByDiagDir(dir))) {
-							/* When we're the first road stop in a 'queue' of them we increase
-							 * cost based on the fill percentage of the whole queue. */
-							const RoadStop::Entry *entry = rs->GetEntry(dir);
-							cost += entry->GetOccupied() * Yapf().PfGetSettings().road_stop_occupied_penalty / entry->GetLength();
-						}
-					} else {
-						/* Increase cost for filled road stops */
-						cost += Yapf().PfGetSettings().road_stop_bay_occupied_penalty * (!rs->IsFreeBay(0) + !rs->IsFreeBay(1)) / 2;
-					}
+					int stop_cost = RoadStopCost(tile, trackdir, Yapf().PfGetSettings());
+					if (m_record != nullptr) m_record->stop_costs.push_back({tile, trackdir, stop_cost});
+					cost += stop_cost;
 					break;
 				}
 
@@ -104,6 +149,12 @@ public:
 		m_max_cost = max_cost;
 	}
 
+	/** Record the tiles and road stop costs the result of the search depends on. */
+	inline void SetPathRecord(YapfRoadPathRecord *record)
+	{
+		m_record = record;
+	}
+
 	/**
 	 * Called by YAPF to calculate the cost from the origin to the given node.
 	 *  Calculates only the cost of given node, adds it to the parent node cost
@@ -234,6 +285,8 @@ protected:
 	StationID    m_dest_station;
 	bool         m_bus;
 	bool         m_non_artic;
+	const YapfLandmarks *m_landmarks = nullptr; ///< landmark distances of the road network, if they are used
+	YapfLandmarkTarget   m_landmark_target;     ///< edges of the destination tiles for the landmark estimate
 
 public:
 	void SetDestination(const RoadVehicle *v)
@@ -249,6 +302,20 @@ public:
 			m_destTile      = v->dest_tile;
 			m_destTrackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(v->dest_tile, TRANSPORT_ROAD, GetRoadTramType(v->roadtype)));
 		}
+
+		if (Yapf().PfGetSettings().use_landmarks && RoadLandmarksUsable()) {
+			m_landmarks = &YapfLandmarks::Get(TRANSPORT_ROAD);
+			m_landmark_target.Clear();
+			if (m_dest_station != INVALID_STATION) {
+				TileArea ta;
+				Station::Get(m_dest_station)->GetTileArea(&ta, m_bus ? STATION_BUS : STATION_TRUCK);
+				for (TileIndex tile : ta) {
+					if (PfDetectDestinationTile(tile, INVALID_TRACKDIR)) m_landmarks->AddTargetTile(m_landmark_target, tile);
+				}
+			} else {
+				m_landmarks->AddTargetTile(m_landmark_target, m_destTile);
+			}
+		}
 	}
 
 	const Station *GetDestinationStation() const
@@ -306,6 +373,7 @@ public:
 		int dmin = std::min(dx, dy);
 		int dxy = abs(dx - dy);
 		int d = dmin * YAPF_TILE_CORNER_LENGTH + (dxy - 1) * (YAPF_TILE_LENGTH / 2);
+		if (m_landmarks != nullptr) d = std::max(d, m_landmarks->GetEstimate(m_landmark_target, tile, exitdir));
 		n.m_estimate = n.m_cost + d;
 		assert(n.m_estimate >= n.m_parent->m_estimate);
 		return true;
@@ -351,9 +419,10 @@ public:
 		return 'r';
 	}
 
-	static Trackdir stChooseRoadTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, bool &path_found, RoadVehPathCache &path_cache)
+	static Trackdir stChooseRoadTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, bool &path_found, RoadVehPathCache &path_cache, YapfRoadPathRecord *record)
 	{
 		Tpf pf;
+		pf.SetPathRecord(record);
 		return pf.ChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
 	}
 
@@ -402,27 +471,6 @@ public:
 			Node &best_next_node = *pNode;
 			assert(best_next_node.GetTile() == tile);
 			next_trackdir = best_next_node.GetTrackdir();
-			/* remove last element for the special case when tile == dest_tile */
-			if (path_found && !path_cache.empty() && tile == v->dest_tile) {
-				path_cache.td.pop_back();
-				path_cache.tile.pop_back();
-			}
-
-			/* Check if target is a station, and cached path ends within 8 tiles of the dest tile */
-			const Station *st = Yapf().GetDestinationStation();
-			if (st) {
-				const RoadStop *stop = st->GetPrimaryRoadStop(v);
-				if (stop != nullptr && (IsDriveThroughStopTile(stop->xy) || stop->GetNextRoadStop(v) != nullptr)) {
-					/* Destination station has at least 2 usable road stops, or first is a drive-through stop,
-					 * trim end of path cache within a number of tiles of road stop tile area */
-					TileArea non_cached_area = v->IsBus() ? st->bus_station : st->truck_station;
-					non_cached_area.Expand(YAPF_ROADVEH_PATH_CACHE_DESTINATION_LIMIT);
-					while (!path_cache.empty() && non_cached_area.Contains(path_cache.tile.back())) {
-						path_cache.td.pop_back();
-						path_cache.tile.pop_back();
-					}
-				}
-			}
 		}
 		return next_trackdir;
 	}
@@ -529,10 +577,249 @@ struct CYapfRoadAnyDepot1 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot1, CRoadNod
 struct CYapfRoadAnyDepot2 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot2, CRoadNodeListExitDir , CYapfDestinationAnyDepotRoadT> > {};
 
 
+/** The inputs of a road vehicle's path search, besides the state of the map. */
+struct YapfRoadPathKey {
+	TileIndex tile;                 ///< The tile the vehicle chooses its trackdir on.
+	DiagDirection enterdir;         ///< The direction the vehicle enters the tile with.
+	TileIndex dest_tile;            ///< The destination tile, which is the closest station tile for stations.
+	StationID dest_station;         ///< The destination station, if going to one.
+	Owner owner;                    ///< The owner of the vehicle.
+	RoadType roadtype;              ///< The road type of the vehicle.
+	RoadTypes compatible_roadtypes; ///< The road types the vehicle can drive on.
+	int max_speed;                  ///< The speed the vehicle can drive with.
+	bool bus;                       ///< Whether the vehicle is a bus.
+	bool articulated;               ///< Whether the vehicle is articulated.
+
+	YapfRoadPathKey(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir) :
+		tile(tile), enterdir(enterdir), owner(v->owner), roadtype(v->roadtype), compatible_roadtypes(v->compatible_roadtypes),
+		max_speed(std::min<int>(v->GetDisplayMaxSpeed(), v->current_order.GetMaxSpeed() * 2)), bus(v->IsBus()), articulated(v->HasArticulatedPart())
+	{
+		if (v->current_order.IsType(OT_GOTO_STATION)) {
+			this->dest_station = v->current_order.GetDestination();
+			this->dest_tile = CalcClosestStationTile(this->dest_station, v->tile, this->bus ? STATION_BUS : STATION_TRUCK);
+		} else {
+			this->dest_station = INVALID_STATION;
+			this->dest_tile = v->dest_tile;
+		}
+	}
+
+	bool operator==(const YapfRoadPathKey &other) const
+	{
+		return this->tile == other.tile && this->enterdir == other.enterdir && this->dest_tile == other.dest_tile &&
+				this->dest_station == other.dest_station && this->owner == other.owner && this->roadtype == other.roadtype &&
+				this->compatible_roadtypes == other.compatible_roadtypes && this->max_speed == other.max_speed &&
+				this->bus == other.bus && this->articulated == other.articulated;
+	}
+};
+
+/**
+ * Recent results of path searches of road vehicles. Vehicles following each
+ * other on a line choose their way on the same junctions to the same
+ * destinations, so the result of the first one can be reused by the others
+ * as long as nothing the search passed has changed. Reusing a result has to
+ * give exactly what a new search would give, else clients would desync.
+ */
+class YapfRoadPathCache {
+	/** A search result. */
+	struct Entry {
+		YapfRoadPathKey key;       ///< The inputs of the search.
+		YapfRoadPathRecord record; ///< What the result depends on.
+		VehicleID vehicle;         ///< The vehicle that did the search.
+		Trackdir trackdir;         ///< The chosen trackdir.
+		bool path_found;           ///< Whether a path to the destination was found.
+		RoadVehPathCache path;     ///< The path the vehicle will follow.
+	};
+
+	static const uint SIZE = 64; ///< The number of results that are kept.
+
+	std::vector<Entry> entries;  ///< The results, replaced in order.
+	uint next_entry = 0;         ///< The entry to replace next.
+	YAPFSettings settings;       ///< The pathfinder settings the results are valid for.
+	bool landmarks_used = false; ///< Whether the results used the road landmark distances.
+	uint32 landmark_version = 0; ///< The version of the road landmark distances the results are valid for.
+	uint lookups = 0;            ///< The number of times a result was looked for.
+	uint hits = 0;               ///< The number of times a result could be reused.
+
+	/**
+	 * Check whether the road stops the search passed are as busy as they were.
+	 * @param record What a search result depends on.
+	 * @return True iff the costs of all road stops are unchanged.
+	 */
+	static bool StopCostsValid(const YapfRoadPathRecord &record)
+	{
+		for (const YapfRoadPathRecord::StopCost &stop : record.stop_costs) {
+			if (RoadStopCost(stop.tile, stop.trackdir, _settings_game.pf.yapf) != stop.cost) return false;
+		}
+		return true;
+	}
+
+	/** Forget all results when the pathfinder settings or the landmark distances changed. */
+	void Validate()
+	{
+		if (memcmp(&this->settings, &_settings_game.pf.yapf, sizeof(YAPFSettings)) != 0) {
+			this->Clear();
+			memcpy(&this->settings, &_settings_game.pf.yapf, sizeof(YAPFSettings));
+		}
+		if (this->settings.use_landmarks) {
+			/* The landmark estimates may change everywhere, and with them the chosen paths. */
+			bool landmarks_used = RoadLandmarksUsable();
+			uint32 landmark_version = landmarks_used ? YapfLandmarks::Get(TRANSPORT_ROAD).GetVersion() : 0;
+			if (landmarks_used != this->landmarks_used || landmark_version != this->landmark_version) {
+				this->Clear();
+				this->landmarks_used = landmarks_used;
+				this->landmark_version = landmark_version;
+			}
+		}
+	}
+
+public:
+	/**
+	 * Find a search result that is still valid.
+	 * @param key The inputs of the search.
+	 * @return The search result, or nullptr if the search has to be done.
+	 */
+	const Entry *Find(const YapfRoadPathKey &key)
+	{
+		this->Validate();
+
+		this->lookups++;
+		for (const Entry &entry : this->entries) {
+			if (!(entry.key == key) || !StopCostsValid(entry.record)) continue;
+			this->hits++;
+			return &entry;
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Store a search result.
+	 * @param key The inputs of the search.
+	 * @param record What the result depends on.
+	 * @param vehicle The vehicle that did the search.
+	 * @param trackdir The chosen trackdir.
+	 * @param path_found Whether a path to the destination was found.
+	 * @param path The path the vehicle will follow.
+	 */
+	void Add(const YapfRoadPathKey &key, YapfRoadPathRecord &&record, VehicleID vehicle, Trackdir trackdir, bool path_found, const RoadVehPathCache &path)
+	{
+		Entry entry{key, std::move(record), vehicle, trackdir, path_found, path};
+		if (this->entries.size() < SIZE) {
+			this->entries.push_back(std::move(entry));
+			return;
+		}
+		this->entries[this->next_entry] = std::move(entry);
+		this->next_entry = (this->next_entry + 1) % SIZE;
+	}
+
+	/**
+	 * Forget the results of the searches that passed near a changed tile.
+	 * @param tile The changed tile, or INVALID_TILE to forget all results.
+	 */
+	void Invalidate(TileIndex tile)
+	{
+		if (tile == INVALID_TILE) {
+			this->Clear();
+			return;
+		}
+		/* Changes to the tiles next to the passed ones may also add or remove ways. */
+		this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(), [tile](const Entry &entry) {
+			TileArea area = entry.record.area;
+			return area.tile != INVALID_TILE && area.Expand(1).Contains(tile);
+		}), this->entries.end());
+		this->next_entry = 0;
+	}
+
+	/**
+	 * Forget the results of the searches towards a station, e.g. because a road stop was built or removed.
+	 * The destination tiles and with them the landmark estimates of the station change, even when the
+	 * road layout does not.
+	 * @param station The station.
+	 */
+	void InvalidateStation(StationID station)
+	{
+		this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(), [station](const Entry &entry) {
+			return entry.key.dest_station == station;
+		}), this->entries.end());
+		this->next_entry = 0;
+	}
+
+	/**
+	 * Check whether the results that may be reused match what a new search gives.
+	 * Only results of which the searching vehicle still has the same inputs can be checked.
+	 * @param choose_road_track The pathfinder to search with.
+	 * @return True if all checked results match.
+	 */
+	template <typename Tfunc>
+	bool Check(Tfunc choose_road_track)
+	{
+		this->Validate();
+
+		bool match = true;
+		for (const Entry &entry : this->entries) {
+			const RoadVehicle *v = RoadVehicle::GetIfValid(entry.vehicle);
+			if (v == nullptr || !v->IsFrontEngine() || !StopCostsValid(entry.record)) continue;
+			if (!(YapfRoadPathKey(v, entry.key.tile, entry.key.enterdir) == entry.key)) continue;
+
+			bool path_found;
+			RoadVehPathCache path;
+			Trackdir trackdir = choose_road_track(v, entry.key.tile, entry.key.enterdir, path_found, path, nullptr);
+			if (trackdir != entry.trackdir || path_found != entry.path_found || path.td != entry.path.td || path.tile != entry.path.tile) match = false;
+		}
+		return match;
+	}
+
+	/** Forget all search results. */
+	void Clear()
+	{
+		this->entries.clear();
+		this->next_entry = 0;
+	}
+
+	/** Get the share of lookups that could reuse a result, in percent. */
+	float GetHitRate() const
+	{
+		return this->lookups == 0 ? 0.0f : (float)this->hits / (float)this->lookups * 100.0f;
+	}
+};
+
+static YapfRoadPathCache _road_path_cache; ///< Recent results of path searches of road vehicles.
+
+/**
+ * Remove the end of a path the vehicle should not follow blindly.
+ * @param v The vehicle.
+ * @param tile The tile the vehicle chooses its trackdir on.
+ * @param path_found Whether a path to the destination was found.
+ * @param path_cache The path of the vehicle.
+ */
+static void TrimRoadVehPathCache(const RoadVehicle *v, TileIndex tile, bool path_found, RoadVehPathCache &path_cache)
+{
+	/* remove last element for the special case when tile == dest_tile */
+	if (path_found && !path_cache.empty() && tile == v->dest_tile) {
+		path_cache.td.pop_back();
+		path_cache.tile.pop_back();
+	}
+
+	/* Check if target is a station, and cached path ends within 8 tiles of the dest tile */
+	const Station *st = v->current_order.IsType(OT_GOTO_STATION) ? Station::GetIfValid(v->current_order.GetDestination()) : nullptr;
+	if (st) {
+		const RoadStop *stop = st->GetPrimaryRoadStop(v);
+		if (stop != nullptr && (IsDriveThroughStopTile(stop->xy) || stop->GetNextRoadStop(v) != nullptr)) {
+			/* Destination station has at least 2 usable road stops, or first is a drive-through stop,
+			 * trim end of path cache within a number of tiles of road stop tile area */
+			TileArea non_cached_area = v->IsBus() ? st->bus_station : st->truck_station;
+			non_cached_area.Expand(YAPF_ROADVEH_PATH_CACHE_DESTINATION_LIMIT);
+			while (!path_cache.empty() && non_cached_area.Contains(path_cache.tile.back())) {
+				path_cache.td.pop_back();
+				path_cache.tile.pop_back();
+			}
+		}
+	}
+}
+
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache)
 {
 	/* default is YAPF type 2 */
-	typedef Trackdir (*PfnChooseRoadTrack)(const RoadVehicle*, TileIndex, DiagDirection, bool &path_found, RoadVehPathCache &path_cache);
+	typedef Trackdir (*PfnChooseRoadTrack)(const RoadVehicle*, TileIndex, DiagDirection, bool &path_found, RoadVehPathCache &path_cache, YapfRoadPathRecord *record);
 	PfnChooseRoadTrack pfnChooseRoadTrack = &CYapfRoad2::stChooseRoadTrack; // default: ExitDir, allow 90-deg
 
 	/* check if non-default YAPF type should be used */
@@ -540,7 +827,31 @@ Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDi
 		pfnChooseRoadTrack = &CYapfRoad1::stChooseRoadTrack; // Trackdir
 	}
 
-	Trackdir td_ret = pfnChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
+	Trackdir td_ret;
+	YapfRoadPathKey key(v, tile, enterdir);
+	const auto *cached = _road_path_cache.Find(key);
+	if (cached != nullptr) {
+		td_ret = cached->trackdir;
+		path_found = cached->path_found;
+		path_cache = cached->path;
+		DEBUG(yapf, 3, "[YAPFr]-%4d- reused an earlier result - hit rate %4.1f%%", v->unitnumber, _road_path_cache.GetHitRate());
+
+		if (_debug_desync_level >= 2) {
+			bool path_found2;
+			RoadVehPathCache path_cache2;
+			Trackdir td_ret2 = pfnChooseRoadTrack(v, tile, enterdir, path_found2, path_cache2, nullptr);
+			if (td_ret != td_ret2 || path_found != path_found2 || path_cache.td != path_cache2.td || path_cache.tile != path_cache2.tile) {
+				DEBUG(desync, 2, "CACHE ERROR: YapfRoadVehicleChooseTrack() = [%d, %d]", td_ret, td_ret2);
+			}
+		}
+	} else {
+		YapfRoadPathRecord record;
+		record.area.Add(tile);
+		td_ret = pfnChooseRoadTrack(v, tile, enterdir, path_found, path_cache, &record);
+		_road_path_cache.Add(key, std::move(record), v->index, td_ret, path_found, path_cache);
+	}
+
+	TrimRoadVehPathCache(v, tile, path_found, path_cache);
 	return (td_ret != INVALID_TRACKDIR) ? td_ret : (Trackdir)FindFirstBit2x64(trackdirs);
 }
 
@@ -564,3 +875,29 @@ FindDepotData YapfRoadVehicleFindNearestDepot(const RoadVehicle *v, int max_dist
 
 	return pfnFindNearestDepot(v, tile, trackdir, max_distance);
 }
+
+void YapfNotifyRoadLayoutChange(TileIndex tile)
+{
+	/* Town growth changes the road network all the time; do not recompute the
+	 * landmark distances for each piece of road, but start a day without them.
+	 * Loading or starting a game does not change the network. */
+	if (tile != INVALID_TILE && _date > _yapf_road_layout_change_date) _yapf_road_layout_change_date = _date;
+	InvalidateYapfLandmarks(TRANSPORT_ROAD);
+	YapfNotifyRoadCostChange(tile);
+}
+
+void YapfNotifyRoadCostChange(TileIndex tile)
+{
+	_road_path_cache.Invalidate(tile);
+}
+
+void YapfNotifyRoadStopChange(TileIndex tile, StationID station)
+{
+	YapfNotifyRoadLayoutChange(tile);
+	_road_path_cache.InvalidateStation(station);
+}
+
+bool YapfCheckRoadPathCache()
+{
+	return _road_path_cache.Check(_settings_game.pf.yapf.disable_node_optimization ? &CYapfRoad1::stChooseRoadTrack : &CYapfRoad2::stChooseRoadTrack);
+}
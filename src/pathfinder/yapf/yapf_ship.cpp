@@ -14,9 +14,13 @@
 
 #include "yapf.hpp"
 #include "yapf_node_ship.hpp"
+#include "yapf_ship_regions.h"
 
 #include "../../safeguards.h"
 
+/** Number of water regions ahead of the ship the tile-level search looks at when the destination is further away. */
+static const int NUMBER_OF_WATER_REGIONS_LOOKAHEAD = 4;
+
 template <class Types>
 class CYapfDestinationTileWaterT
 {
@@ -31,6 +35,10 @@ protected:
 	TrackdirBits m_destTrackdirs;
 	StationID    m_destStation;
 
+	bool                 m_has_intermediate_dest;             ///< whether the search stops at a patch of water on the way to the destination
+	TileIndex            m_intermediate_dest_tile;            ///< tile the distance to the intermediate destination is estimated to
+	WaterRegionPatchDesc m_intermediate_dest_region_patch;    ///< the intermediate destination
+
 public:
 	void SetDestination(const Ship *v)
 	{
@@ -43,6 +51,18 @@ public:
 			m_destTile      = v->dest_tile;
 			m_destTrackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(v->dest_tile, TRANSPORT_WATER, 0));
 		}
+		m_has_intermediate_dest = false;
+	}
+
+	/**
+	 * Stop the search as soon as a patch of water on the way to the destination is reached.
+	 * @param water_region_patch The patch to stop at.
+	 */
+	void SetIntermediateDestination(const WaterRegionPatchDesc &water_region_patch)
+	{
+		m_has_intermediate_dest = true;
+		m_intermediate_dest_tile = GetWaterRegionCenterTile(water_region_patch);
+		m_intermediate_dest_region_patch = water_region_patch;
 	}
 
 protected:
@@ -61,6 +81,8 @@ public:
 
 	inline bool PfDetectDestinationTile(TileIndex tile, Trackdir trackdir)
 	{
+		if (m_has_intermediate_dest && GetWaterRegionPatchInfo(tile) == m_intermediate_dest_region_patch) return true;
+
 		if (m_destStation != INVALID_STATION) {
 			return IsDockingTile(tile) && IsShipDestinationTile(tile, m_destStation);
 		}
@@ -85,8 +107,9 @@ public:
 		DiagDirection exitdir = TrackdirToExitdir(n.m_segment_last_td);
 		int x1 = 2 * TileX(tile) + dg_dir_to_x_offs[(int)exitdir];
 		int y1 = 2 * TileY(tile) + dg_dir_to_y_offs[(int)exitdir];
-		int x2 = 2 * TileX(m_destTile);
-		int y2 = 2 * TileY(m_destTile);
+		TileIndex dest_tile = m_has_intermediate_dest ? m_intermediate_dest_tile : m_destTile;
+		int x2 = 2 * TileX(dest_tile);
+		int y2 = 2 * TileY(dest_tile);
 		int dx = abs(x1 - x2);
 		int dy = abs(y1 - y2);
 		int dmin = std::min(dx, dy);
@@ -110,6 +133,8 @@ public:
 	typedef typename Node::Key Key;                      ///< key to hash tables
 
 protected:
+	std::vector<WaterRegionPatchDesc> m_water_region_patches; ///< patches of water the search is restricted to; empty if not restricted
+
 	/** to access inherited path finder */
 	inline Tpf& Yapf()
 	{
@@ -117,6 +142,15 @@ protected:
 	}
 
 public:
+	/**
+	 * Only look at tiles in the given patches of water.
+	 * @param path The patches to search.
+	 */
+	void RestrictSearch(const std::vector<WaterRegionPatchDesc> &path)
+	{
+		m_water_region_patches = path;
+	}
+
 	/**
 	 * Called by YAPF to move from the given node to the next tile. For each
 	 *  reachable trackdir on the new tile creates new node, initializes it
@@ -126,6 +160,10 @@ public:
 	{
 		TrackFollower F(Yapf().GetVehicle());
 		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td)) {
+			if (!m_water_region_patches.empty()) {
+				WaterRegionPatchDesc water_region_patch = GetWaterRegionPatchInfo(F.m_new_tile);
+				if (std::find(m_water_region_patches.begin(), m_water_region_patches.end(), water_region_patch) == m_water_region_patches.end()) return;
+			}
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
@@ -158,43 +196,56 @@ public:
 		/* convert origin trackdir to TrackdirBits */
 		TrackdirBits trackdirs = TrackdirToTrackdirBits(trackdir);
 
-		/* create pathfinder instance */
-		Tpf pf;
-		/* set origin and destination nodes */
-		pf.SetOrigin(src_tile, trackdirs);
-		pf.SetDestination(v);
-		/* find best path */
-		path_found = pf.FindPath(v);
-
-		Trackdir next_trackdir = INVALID_TRACKDIR; // this would mean "path not found"
-
-		Node *pNode = pf.GetBestNode();
-		if (pNode != nullptr) {
-			uint steps = 0;
-			for (Node *n = pNode; n->m_parent != nullptr; n = n->m_parent) steps++;
-			uint skip = 0;
-			if (path_found) skip = YAPF_SHIP_PATH_CACHE_LENGTH / 2;
-
-			/* walk through the path back to the origin */
-			Node *pPrevNode = nullptr;
-			while (pNode->m_parent != nullptr) {
-				steps--;
-				/* Skip tiles at end of path near destination. */
-				if (skip > 0) skip--;
-				if (skip == 0 && steps > 0 && steps < YAPF_SHIP_PATH_CACHE_LENGTH) {
-					path_cache.push_front(pNode->GetTrackdir());
+		/* Plan the route through the water regions first, so a far away destination
+		 * can be approached a few regions at a time. If no route is found that way,
+		 * fall back to a plain search to get the best guess where to go. */
+		const std::vector<WaterRegionPatchDesc> high_level_path = YapfShipFindWaterRegionPath(v, src_tile, NUMBER_OF_WATER_REGIONS_LOOKAHEAD + 1);
+		const bool is_intermediate_destination = (int)high_level_path.size() > NUMBER_OF_WATER_REGIONS_LOOKAHEAD;
+
+		/* The first search is not restricted, which generally gives more natural looking paths. If it runs
+		 * out of nodes, e.g. in a maze of canals, search again within the water regions of the route. */
+		for (int attempt = 0;; attempt++) {
+			/* create pathfinder instance */
+			Tpf pf;
+			/* set origin and destination nodes */
+			pf.SetOrigin(src_tile, trackdirs);
+			pf.SetDestination(v);
+			if (is_intermediate_destination) pf.SetIntermediateDestination(high_level_path.back());
+			if (attempt > 0) pf.RestrictSearch(high_level_path);
+			/* find best path */
+			path_found = pf.FindPath(v);
+			if (!path_found && attempt == 0 && !high_level_path.empty()) continue;
+
+			Trackdir next_trackdir = INVALID_TRACKDIR; // this would mean "path not found"
+
+			Node *pNode = pf.GetBestNode();
+			if (pNode != nullptr) {
+				uint steps = 0;
+				for (Node *n = pNode; n->m_parent != nullptr; n = n->m_parent) steps++;
+				uint skip = 0;
+				if (path_found) skip = YAPF_SHIP_PATH_CACHE_LENGTH / 2;
+
+				/* walk through the path back to the origin */
+				Node *pPrevNode = nullptr;
+				while (pNode->m_parent != nullptr) {
+					steps--;
+					/* Skip tiles at end of path near destination. */
+					if (skip > 0) skip--;
+					if (skip == 0 && steps > 0 && steps < YAPF_SHIP_PATH_CACHE_LENGTH) {
+						path_cache.push_front(pNode->GetTrackdir());
+					}
+					pPrevNode = pNode;
+					pNode = pNode->m_parent;
 				}
-				pPrevNode = pNode;
-				pNode = pNode->m_parent;
+				/* return trackdir from the best next node (direct child of origin) */
+				Node &best_next_node = *pPrevNode;
+				assert(best_next_node.GetTile() == tile);
+				next_trackdir = best_next_node.GetTrackdir();
+				/* remove last element for the special case when tile == dest_tile */
+				if (path_found && !path_cache.empty()) path_cache.pop_back();
 			}
-			/* return trackdir from the best next node (direct child of origin) */
-			Node &best_next_node = *pPrevNode;
-			assert(best_next_node.GetTile() == tile);
-			next_trackdir = best_next_node.GetTrackdir();
-			/* remove last element for the special case when tile == dest_tile */
-			if (path_found && !path_cache.empty()) path_cache.pop_back();
+			return next_trackdir;
 		}
-		return next_trackdir;
 	}
 
 	/**
@@ -0,0 +1,357 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_ship_regions.cpp Implementation of YAPF for water regions, which are used for finding intermediate ship destinations. */
+
+#include "../../stdafx.h"
+#include "../../ship.h"
+
+#include "yapf.hpp"
+#include "yapf_ship_regions.h"
+
+#include "../../safeguards.h"
+
+static const int NODES_PER_REGION = 4;            ///< Number of nodes reserved per water region; most regions have only one or two patches.
+static const int MAX_NUMBER_OF_NODES = 65536;     ///< Upper limit of the number of nodes, i.e. one node per region on the largest maps.
+
+/** Yapf Node Key that represents a single patch of interconnected water within a water region. */
+struct CYapfRegionPatchNodeKey {
+	WaterRegionPatchDesc m_water_region_patch;
+
+	inline void Set(const WaterRegionPatchDesc &water_region_patch)
+	{
+		m_water_region_patch = water_region_patch;
+	}
+
+	inline int CalcHash() const
+	{
+		return CalculateWaterRegionPatchHash(m_water_region_patch);
+	}
+
+	inline bool operator==(const CYapfRegionPatchNodeKey &other) const
+	{
+		return m_water_region_patch == other.m_water_region_patch;
+	}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteValue("m_x", m_water_region_patch.x);
+		dmp.WriteValue("m_y", m_water_region_patch.y);
+		dmp.WriteValue("m_label", m_water_region_patch.label);
+	}
+};
+
+/**
+ * Manhattan distance between two water regions.
+ * @param a The first patch.
+ * @param b The second patch.
+ * @return The distance in water regions.
+ */
+static inline uint ManhattanDistance(const CYapfRegionPatchNodeKey &a, const CYapfRegionPatchNodeKey &b)
+{
+	return abs(a.m_water_region_patch.x - b.m_water_region_patch.x) + abs(a.m_water_region_patch.y - b.m_water_region_patch.y);
+}
+
+/** Yapf Node for water regions */
+template <class Tkey_>
+struct CYapfRegionNodeT {
+	typedef Tkey_ Key;
+	typedef CYapfRegionNodeT<Tkey_> Node;
+
+	Tkey_       m_key;
+	Node       *m_hash_next;
+	Node       *m_parent;
+	int         m_cost;
+	int         m_estimate;
+
+	inline void Set(Node *parent, const WaterRegionPatchDesc &water_region_patch)
+	{
+		m_key.Set(water_region_patch);
+		m_hash_next = nullptr;
+		m_parent = parent;
+		m_cost = 0;
+		m_estimate = 0;
+	}
+
+	inline Node *GetHashNext()
+	{
+		return m_hash_next;
+	}
+
+	inline void SetHashNext(Node *pNext)
+	{
+		m_hash_next = pNext;
+	}
+
+	inline const Tkey_& GetKey() const
+	{
+		return m_key;
+	}
+
+	inline int GetCost() const
+	{
+		return m_cost;
+	}
+
+	inline int GetCostEstimate() const
+	{
+		return m_estimate;
+	}
+
+	inline bool operator<(const Node &other) const
+	{
+		return m_estimate < other.m_estimate;
+	}
+
+	void Dump(DumpTarget &dmp) const
+	{
+		dmp.WriteStructT("m_key", &m_key);
+		dmp.WriteStructT("m_parent", m_parent);
+		dmp.WriteValue("m_cost", m_cost);
+		dmp.WriteValue("m_estimate", m_estimate);
+	}
+};
+
+/** YAPF origin provider for water regions - used when there are any number of origin patches */
+template <class Types>
+class CYapfOriginRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::NodeList::Titem Node; ///< this will be our node type
+	typedef typename Node::Key Key;               ///< key to hash tables
+
+protected:
+	std::vector<CYapfRegionPatchNodeKey> m_origin_keys; ///< origin patches
+
+	/** to access inherited path finder */
+	inline Tpf& Yapf()
+	{
+		return *static_cast<Tpf *>(this);
+	}
+
+public:
+	/** Add an origin patch */
+	void AddOrigin(const WaterRegionPatchDesc &water_region_patch)
+	{
+		if (water_region_patch.label == INVALID_WATER_REGION_PATCH || HasOrigin(water_region_patch)) return;
+		m_origin_keys.emplace_back();
+		m_origin_keys.back().Set(water_region_patch);
+	}
+
+	/** Check whether a patch is one of the origins */
+	bool HasOrigin(const WaterRegionPatchDesc &water_region_patch)
+	{
+		for (const CYapfRegionPatchNodeKey &key : m_origin_keys) {
+			if (key.m_water_region_patch == water_region_patch) return true;
+		}
+		return false;
+	}
+
+	/** Called when YAPF needs to place origin nodes into open list */
+	void PfSetStartupNodes()
+	{
+		for (const CYapfRegionPatchNodeKey &origin_key : m_origin_keys) {
+			Node &node = Yapf().CreateNewNode();
+			node.Set(nullptr, origin_key.m_water_region_patch);
+			Yapf().AddStartupNode(node);
+		}
+	}
+};
+
+/** YAPF destination provider for water regions - used when destination is a single patch */
+template <class Types>
+class CYapfDestinationRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::NodeList::Titem Node; ///< this will be our node type
+	typedef typename Node::Key Key;               ///< key to hash tables
+
+protected:
+	Key m_dest;                                   ///< destination patch
+
+public:
+	void SetDestination(const WaterRegionPatchDesc &water_region_patch)
+	{
+		m_dest.Set(water_region_patch);
+	}
+
+protected:
+	/** to access inherited path finder */
+	inline Tpf& Yapf()
+	{
+		return *static_cast<Tpf *>(this);
+	}
+
+public:
+	/** Called by YAPF to detect if node ends in the desired destination */
+	inline bool PfDetectDestination(Node &n) const
+	{
+		return n.m_key == m_dest;
+	}
+
+	/**
+	 * Called by YAPF to calculate cost estimate. Calculates distance to the destination
+	 *  adds it to the actual cost from origin and stores the sum to the Node::m_estimate
+	 */
+	inline bool PfCalcEstimate(Node &n)
+	{
+		if (PfDetectDestination(n)) {
+			n.m_estimate = n.m_cost;
+			return true;
+		}
+
+		n.m_estimate = n.m_cost + ManhattanDistance(n.m_key, m_dest);
+		return true;
+	}
+};
+
+/** Node Follower module of YAPF for water regions */
+template <class Types>
+class CYapfFollowRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;                     ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node;        ///< this will be our node type
+	typedef typename Node::Key Key;                      ///< key to hash tables
+
+protected:
+	std::vector<WaterRegionPatchDesc> m_neighbours;      ///< neighbours of the node being followed
+
+	/** to access inherited path finder */
+	inline Tpf& Yapf()
+	{
+		return *static_cast<Tpf *>(this);
+	}
+
+public:
+	/** Called by YAPF to move from the given node to the neighbouring patches of water */
+	inline void PfFollowNode(Node &old_node)
+	{
+		GetWaterRegionPatchNeighbours(old_node.m_key.m_water_region_patch, m_neighbours);
+		for (const WaterRegionPatchDesc &water_region_patch : m_neighbours) {
+			Node &node = Yapf().CreateNewNode();
+			node.Set(&old_node, water_region_patch);
+			Yapf().AddNewNode(node, TrackFollower());
+		}
+	}
+
+	/** return debug report character to identify the transportation type */
+	inline char TransportTypeChar() const
+	{
+		return '^';
+	}
+
+	/**
+	 * Find the patches of water a ship should sail through, starting at its current location.
+	 * @param v The ship.
+	 * @param start_tile The tile to start from.
+	 * @param max_returned_path_length Maximum number of patches to return.
+	 * @return The patches, starting with the patch of \a start_tile; empty when the destination can not be reached.
+	 */
+	static std::vector<WaterRegionPatchDesc> FindWaterRegionPath(const Ship *v, TileIndex start_tile, int max_returned_path_length)
+	{
+		const WaterRegionPatchDesc start_water_region_patch = GetWaterRegionPatchInfo(start_tile);
+		if (start_water_region_patch.label == INVALID_WATER_REGION_PATCH) return {};
+
+		/* The search runs from the destination back to the ship, so the path can be read from the parents of the best node. */
+		Tpf pf(std::min(static_cast<int>(MapSize() * NODES_PER_REGION / WATER_REGION_NUMBER_OF_TILES), MAX_NUMBER_OF_NODES));
+		pf.SetDestination(start_water_region_patch);
+
+		if (v->current_order.IsType(OT_GOTO_STATION)) {
+			StationID station_id = v->current_order.GetDestination();
+			const Station *st = Station::Get(station_id);
+			for (TileIndex tile : st->docking_station) {
+				if (IsDockingTile(tile) && IsShipDestinationTile(tile, station_id)) pf.AddOrigin(GetWaterRegionPatchInfo(tile));
+			}
+		} else {
+			pf.AddOrigin(GetWaterRegionPatchInfo(v->dest_tile));
+		}
+
+		std::vector<WaterRegionPatchDesc> path = { start_water_region_patch };
+		if (pf.HasOrigin(start_water_region_patch)) return path;
+
+		if (!pf.FindPath(v)) return {};
+
+		for (Node *node = pf.GetBestNode()->m_parent; node != nullptr && (int)path.size() < max_returned_path_length; node = node->m_parent) {
+			path.push_back(node->m_key.m_water_region_patch);
+		}
+		return path;
+	}
+};
+
+/** Cost Provider module of YAPF for water regions */
+template <class Types>
+class CYapfCostRegionT
+{
+public:
+	typedef typename Types::Tpf Tpf;              ///< the pathfinder class (derived from THIS class)
+	typedef typename Types::TrackFollower TrackFollower;
+	typedef typename Types::NodeList::Titem Node; ///< this will be our node type
+	typedef typename Node::Key Key;               ///< key to hash tables
+
+	/**
+	 * Called by YAPF to calculate the cost from the origin to the given node.
+	 *  Calculates only the cost of given node, adds it to the parent node cost
+	 *  and stores the result into Node::m_cost member
+	 */
+	inline bool PfCalcCost(Node &n, const TrackFollower *tf)
+	{
+		n.m_cost = n.m_parent->m_cost + ManhattanDistance(n.m_key, n.m_parent->m_key);
+		return true;
+	}
+};
+
+/**
+ * Config struct of YAPF for route planning.
+ *  Defines all 6 base YAPF modules as classes providing services for CYapfBaseT.
+ */
+template <class Tpf_, class Tnode_list>
+struct CYapfRegion_TypesT
+{
+	/** Types - shortcut for this struct type */
+	typedef CYapfRegion_TypesT<Tpf_, Tnode_list> Types;
+
+	/** Tpf - pathfinder type */
+	typedef Tpf_                              Tpf;
+	/** track follower helper class; not used for following water regions, but YAPF requires one */
+	typedef CFollowTrackWater                 TrackFollower;
+	/** node list type */
+	typedef Tnode_list                        NodeList;
+	typedef Ship                              VehicleType;
+	/** pathfinder components (modules) */
+	typedef CYapfBaseT<Types>                 PfBase;        // base pathfinder class
+	typedef CYapfFollowRegionT<Types>         PfFollow;      // node follower
+	typedef CYapfOriginRegionT<Types>         PfOrigin;      // origin provider
+	typedef CYapfDestinationRegionT<Types>    PfDestination; // destination/distance provider
+	typedef CYapfSegmentCostCacheNoneT<Types> PfCache;       // segment cost cache provider
+	typedef CYapfCostRegionT<Types>           PfCost;        // cost provider
+};
+
+typedef CNodeList_HashTableT<CYapfRegionNodeT<CYapfRegionPatchNodeKey>, 12, 12> CRegionNodeListWater;
+
+struct CYapfRegionWater : CYapfT<CYapfRegion_TypesT<CYapfRegionWater, CRegionNodeListWater>>
+{
+	explicit CYapfRegionWater(int max_nodes)
+	{
+		m_max_search_nodes = max_nodes;
+	}
+};
+
+/**
+ * Finds a path at the water region level. Note that the starting region is always included if the path was found.
+ * @param v The ship to find a path for.
+ * @param start_tile The tile to start searching from.
+ * @param max_returned_path_length The maximum length of the path that will be returned.
+ * @returns A path of water region patches, or an empty vector if no path was found.
+ */
+std::vector<WaterRegionPatchDesc> YapfShipFindWaterRegionPath(const Ship *v, TileIndex start_tile, int max_returned_path_length)
+{
+	return CYapfRegionWater::FindWaterRegionPath(v, start_tile, max_returned_path_length);
+}
@@ -31,6 +31,7 @@
 #include "strings_func.h"
 #include "company_gui.h"
 #include "object_map.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 #include "table/railtypes.h"
@@ -552,6 +553,7 @@ CommandCost CmdBuildSingleRail(TileIndex tile, DoCommandFlag flags, uint32 p1, u
 					if (flags & DC_EXEC) {
 						MakeRoadCrossing(tile, road_owner, tram_owner, _current_company, (track == TRACK_X ? AXIS_Y : AXIS_X), railtype, roadtype_road, roadtype_tram, GetTownIndex(tile));
 						UpdateLevelCrossing(tile, false);
+						YapfNotifyRoadLayoutChange(tile);
 						Company::Get(_current_company)->infrastructure.rail[railtype] += LEVELCROSSING_TRACKBIT_FACTOR;
 						DirtyCompanyInfrastructureWindows(_current_company);
 						if (num_new_road_pieces > 0 && Company::IsValidID(road_owner)) {
@@ -594,6 +596,7 @@ CommandCost CmdBuildSingleRail(TileIndex tile, DoCommandFlag flags, uint32 p1, u
 				MakeRailNormal(tile, _current_company, trackbit, railtype);
 				if (water_ground) {
 					SetRailGroundType(tile, RAIL_GROUND_WATER);
+					InvalidateWaterRegion(tile);
 					if (IsPossibleDockingTile(tile)) CheckForDockingTile(tile);
 				}
 				Company::Get(_current_company)->infrastructure.rail[railtype]++;
@@ -666,6 +669,7 @@ CommandCost CmdRemoveSingleRail(TileIndex tile, DoCommandFlag flags, uint32 p1,
 				DirtyCompanyInfrastructureWindows(owner);
 				MakeRoadNormal(tile, GetCrossingRoadBits(tile), GetRoadTypeRoad(tile), GetRoadTypeTram(tile), GetTownIndex(tile), GetRoadOwner(tile, RTT_ROAD), GetRoadOwner(tile, RTT_TRAM));
 				DeleteNewGRFInspectWindow(GSF_RAILTYPES, tile);
+				YapfNotifyRoadCostChange(tile);
 			}
 			break;
 		}
@@ -720,6 +724,7 @@ CommandCost CmdRemoveSingleRail(TileIndex tile, DoCommandFlag flags, uint32 p1,
 						bool docking = IsDockingTile(tile);
 						MakeShore(tile);
 						SetDockingTile(tile, docking);
+						InvalidateWaterRegion(tile);
 					} else {
 						DoClearSquare(tile);
 					}
@@ -1196,7 +1201,7 @@ CommandCost CmdBuildSingleSignal(TileIndex tile, DoCommandFlag flags, uint32 p1,
 		}
 		MarkTileDirtyByTile(tile);
 		AddTrackToSignalBuffer(tile, track, _current_company);
-		YapfNotifyTrackLayoutChange(tile, track);
+		YapfNotifyTrackCostChange(tile, track);
 		if (v != nullptr && v->track != TRACK_BIT_DEPOT) {
 			/* Extend the train's path if it's not stopped or loading, or not at a safe position. */
 			if (!(((v->vehstatus & VS_STOPPED) && v->cur_speed == 0) || v->current_order.IsType(OT_LOADING)) ||
@@ -1516,7 +1521,7 @@ CommandCost CmdRemoveSingleSignal(TileIndex tile, DoCommandFlag flags, uint32 p1
 		}
 
 		AddTrackToSignalBuffer(tile, track, GetTileOwner(tile));
-		YapfNotifyTrackLayoutChange(tile, track);
+		YapfNotifyTrackCostChange(tile, track);
 		if (v != nullptr) TryPathReserve(v, false);
 
 		MarkTileDirtyByTile(tile);
@@ -1674,8 +1679,8 @@ CommandCost CmdConvertRail(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 				switch (GetRailTileType(tile)) {
 					case RAIL_TILE_DEPOT:
 						if (flags & DC_EXEC) {
-							/* notify YAPF about the track layout change */
-							YapfNotifyTrackLayoutChange(tile, GetRailDepotTrack(tile));
+							/* notify YAPF about the rail type change */
+							YapfNotifyTrackCostChange(tile, GetRailDepotTrack(tile));
 
 							/* Update build vehicle window related to this depot */
 							InvalidateWindowData(WC_VEHICLE_DEPOT, tile);
@@ -1687,10 +1692,10 @@ CommandCost CmdConvertRail(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 
 					default: // RAIL_TILE_NORMAL, RAIL_TILE_SIGNALS
 						if (flags & DC_EXEC) {
-							/* notify YAPF about the track layout change */
+							/* notify YAPF about the rail type change */
 							TrackBits tracks = GetTrackBits(tile);
 							while (tracks != TRACK_BIT_NONE) {
-								YapfNotifyTrackLayoutChange(tile, RemoveFirstTrack(&tracks));
+								YapfNotifyTrackCostChange(tile, RemoveFirstTrack(&tracks));
 							}
 						}
 						found_convertible_track = true;
@@ -1745,8 +1750,8 @@ CommandCost CmdConvertRail(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 					FindVehicleOnPos(tile, &affected_trains, &UpdateTrainPowerProc);
 					FindVehicleOnPos(endtile, &affected_trains, &UpdateTrainPowerProc);
 
-					YapfNotifyTrackLayoutChange(tile, track);
-					YapfNotifyTrackLayoutChange(endtile, track);
+					YapfNotifyTrackCostChange(tile, track);
+					YapfNotifyTrackCostChange(endtile, track);
 
 					if (IsBridge(tile)) {
 						MarkBridgeDirty(tile);
@@ -1764,7 +1769,7 @@ CommandCost CmdConvertRail(TileIndex tile, DoCommandFlag flags, uint32 p1, uint3
 			default: // MP_STATION, MP_ROAD
 				if (flags & DC_EXEC) {
 					Track track = ((tt == MP_STATION) ? GetRailStationTrack(tile) : GetCrossingRailTrack(tile));
-					YapfNotifyTrackLayoutChange(tile, track);
+					YapfNotifyTrackCostChange(tile, track);
 				}
 
 				found_convertible_track = true;
@@ -16,6 +16,7 @@
 #include "../gfx_func.h"
 #include "../core/random_func.hpp"
 #include "../fios.h"
+#include "../pathfinder/yapf/yapf_cache.h"
 
 #include "saveload.h"
 
@@ -90,6 +91,7 @@ static const SaveLoadGlobVarList _date_desc[] = {
 	    SLEG_VAR(_trees_tick_ctr,         SLE_UINT8),
 	SLEG_CONDVAR(_pause_mode,             SLE_UINT8,                   SLV_4, SL_MAX_VERSION),
 	SLE_CONDNULL(4, SLV_11, SLV_120),
+	SLEG_CONDVAR(_yapf_road_layout_change_date, SLE_INT32, SLV_YAPF_ROAD_LAYOUT_CHANGE_DATE, SL_MAX_VERSION),
 	    SLEG_END()
 };
 
@@ -115,6 +117,7 @@ static const SaveLoadGlobVarList _date_check_desc[] = {
 	    SLE_NULL(1),                       // _trees_tick_ctr
 	SLE_CONDNULL(1, SLV_4, SL_MAX_VERSION),    // _pause_mode
 	SLE_CONDNULL(4, SLV_11, SLV_120),
+	SLE_CONDNULL(4, SLV_YAPF_ROAD_LAYOUT_CHANGE_DATE, SL_MAX_VERSION), // _yapf_road_layout_change_date
 	    SLEG_END()
 };
 
@@ -26,9 +26,13 @@
 #include "tile_map.h"
 #include "landscape.h"
 #include "video/video_driver.hpp"
+#include "thread.h"
 
 #include "table/strings.h"
 
+#include <mutex>
+#include <condition_variable>
+
 #include "safeguards.h"
 
 static const char * const SCREENSHOT_NAME = "screenshot"; ///< Default filename of a saved screenshot.
@@ -246,6 +250,157 @@ static void PNGAPI png_my_warning(png_structp png_ptr, png_const_charp message)
 	DEBUG(misc, 1, "[libpng] warning: %s - %s", message, (const char *)png_get_error_ptr(png_ptr));
 }
 
+/**
+ * Strips of rendered lines handed over from the thread rendering a .PNG image to the thread compressing it.
+ * The two strips are used in turn, so one can be rendered while the other is being written.
+ */
+struct PNGStripQueue {
+	png_structp png_ptr;                  ///< The image being written; only touched by the writer thread while it runs.
+	uint row_size;                        ///< Size of a single line in bytes.
+	uint8 *buffers[2];                    ///< The lines of both strips.
+	uint lines[2];                        ///< Number of lines waiting to be written per strip; 0 when the strip may be rendered into.
+	bool finished;                        ///< All strips have been handed over.
+	bool failed;                          ///< libpng failed, so no more strips will be written.
+	std::mutex lock;                      ///< Lock for the strip states.
+	std::condition_variable strip_changed; ///< Signalled whenever a strip changes state.
+
+	PNGStripQueue(png_structp png_ptr, uint row_size, uint maxlines) : png_ptr(png_ptr), row_size(row_size), lines{0, 0}, finished(false), failed(false)
+	{
+		for (uint8 *&buffer : this->buffers) buffer = CallocT<uint8>(row_size * maxlines);
+	}
+
+	~PNGStripQueue()
+	{
+		for (uint8 *buffer : this->buffers) free(buffer);
+	}
+
+	/**
+	 * Wait until a strip may be rendered into.
+	 * @param index The strip to render.
+	 * @return The lines of the strip, or \c nullptr if writing the image failed.
+	 */
+	uint8 *GetFreeStrip(uint index)
+	{
+		std::unique_lock<std::mutex> lock(this->lock);
+		this->strip_changed.wait(lock, [&]() { return this->lines[index] == 0 || this->failed; });
+		return this->failed ? nullptr : this->buffers[index];
+	}
+
+	/**
+	 * Hand a rendered strip over to the writer thread.
+	 * @param index The rendered strip.
+	 * @param n Number of rendered lines.
+	 */
+	void PushStrip(uint index, uint n)
+	{
+		std::lock_guard<std::mutex> lock(this->lock);
+		this->lines[index] = n;
+		this->strip_changed.notify_all();
+	}
+
+	/** Tell the writer thread no more strips will follow. */
+	void Finish()
+	{
+		std::lock_guard<std::mutex> lock(this->lock);
+		this->finished = true;
+		this->strip_changed.notify_all();
+	}
+
+	/**
+	 * Wait until a strip has been rendered.
+	 * @param index The strip to write next.
+	 * @return Number of lines in the strip, or 0 if all strips have been written.
+	 */
+	uint WaitForStrip(uint index)
+	{
+		std::unique_lock<std::mutex> lock(this->lock);
+		this->strip_changed.wait(lock, [&]() { return this->lines[index] != 0 || this->finished; });
+		return this->lines[index];
+	}
+
+	/**
+	 * Give a written strip back to the rendering thread.
+	 * @param index The written strip.
+	 */
+	void ReleaseStrip(uint index)
+	{
+		std::lock_guard<std::mutex> lock(this->lock);
+		this->lines[index] = 0;
+		this->strip_changed.notify_all();
+	}
+
+	/** Tell the rendering thread writing the image failed. */
+	void Fail()
+	{
+		std::lock_guard<std::mutex> lock(this->lock);
+		this->failed = true;
+		this->strip_changed.notify_all();
+	}
+};
+
+/**
+ * Thread compressing and writing the strips of a .PNG image.
+ * @param queue The strips to write.
+ */
+static void PNGWriteStripsThread(PNGStripQueue *queue)
+{
+	/* libpng reports errors by jumping back here, so no objects with destructors may live in this function. */
+	if (setjmp(png_jmpbuf(queue->png_ptr))) {
+		queue->Fail();
+		return;
+	}
+
+	for (uint index = 0;; index ^= 1) {
+		uint n = queue->WaitForStrip(index);
+		if (n == 0) return;
+
+		for (uint i = 0; i != n; i++) {
+			png_write_row(queue->png_ptr, queue->buffers[index] + i * queue->row_size);
+		}
+		queue->ReleaseStrip(index);
+	}
+}
+
+/**
+ * Render the lines of a .PNG image while a separate thread compresses and writes the lines rendered before them.
+ * Compressing takes about as long as rendering, so for giant screenshots this nearly halves the time taken.
+ * @param png_ptr     The image to write the lines to.
+ * @param callb       Callback function for generating lines of pixels.
+ * @param userdata    User data, passed on to \a callb.
+ * @param w           Width of the image in pixels.
+ * @param h           Height of the image in pixels.
+ * @param bpp         Bytes per pixel.
+ * @param maxlines    Number of lines per strip.
+ * @param[out] success Whether all lines were written successfully.
+ * @return Whether the writer thread could be started; if not, nothing has been rendered or written.
+ */
+static bool MakePNGImageRowsThreaded(png_structp png_ptr, ScreenshotCallback *callb, void *userdata, uint w, uint h, uint bpp, uint maxlines, bool &success)
+{
+	PNGStripQueue queue(png_ptr, w * bpp, maxlines);
+
+	std::thread writer;
+	if (!StartNewThread(&writer, "ottd:screenshot", &PNGWriteStripsThread, &queue)) return false;
+
+	uint index = 0;
+	for (uint y = 0; y != h; index ^= 1) {
+		uint8 *buff = queue.GetFreeStrip(index);
+		if (buff == nullptr) break;
+
+		/* determine # lines to write and render them */
+		uint n = std::min(h - y, maxlines);
+		callb(userdata, buff, y, w, n);
+		y += n;
+
+		queue.PushStrip(index, n);
+	}
+
+	queue.Finish();
+	writer.join();
+
+	success = !queue.failed;
+	return true;
+}
+
 /**
  * Generic .PNG file image writer.
  * @param name        Filename, including extension.
@@ -371,6 +526,17 @@ static bool MakePNGImage(const char *name, ScreenshotCallback *callb, void *user
 	/* use by default 64k temp memory */
 	maxlines = Clamp(65536 / w, 16, 128);
 
+	/* images of more than one strip are rendered and written at the same time */
+	bool success = true;
+	if (h > maxlines && MakePNGImageRowsThreaded(png_ptr, callb, userdata, w, h, bpp, maxlines, success)) {
+		/* the writer thread is gone, and so is the jump buffer it set up */
+		if (setjmp(png_jmpbuf(png_ptr))) success = false;
+		if (success) png_write_end(png_ptr, info_ptr);
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		fclose(f);
+		return success;
+	}
+
 	/* now generate the bitmap bits */
 	void *buff = CallocT<uint8>(w * maxlines * bpp); // by default generate 128 lines at a time.
 
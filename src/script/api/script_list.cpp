@@ -460,6 +460,21 @@ void ScriptList::RemoveItem(int64 item)
 	this->items.erase(item_iter);
 }
 
+/**
+ * Remove all items of a range of value buckets.
+ * @param begin First bucket to remove the items of.
+ * @param end Bucket after the last one to remove the items of.
+ */
+void ScriptList::RemoveItems(ScriptListBucket::iterator begin, ScriptListBucket::iterator end)
+{
+	/* RemoveItem() erases emptied buckets, so gather the items first. */
+	std::vector<int64> to_remove;
+	for (ScriptListBucket::iterator iter = begin; iter != end; iter++) {
+		to_remove.insert(to_remove.end(), iter->second.begin(), iter->second.end());
+	}
+	for (int64 item : to_remove) this->RemoveItem(item);
+}
+
 int64 ScriptList::Begin()
 {
 	this->initialized = true;
@@ -521,6 +536,35 @@ bool ScriptList::SetValue(int64 item, int64 value)
 	return true;
 }
 
+/**
+ * Replace the values of all items at once.
+ * @param values The new values, in the order of the items.
+ */
+void ScriptList::SetAllValues(const std::vector<int64> &values)
+{
+	this->modifications++;
+
+	assert(values.size() == this->items.size());
+	std::vector<int64>::const_iterator value = values.begin();
+
+	if (!this->sorter->IsEnd()) {
+		/* The sorter holds iterators into the buckets; let it follow every change. */
+		for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter++) {
+			this->SetValue((*iter).first, *value++);
+		}
+		return;
+	}
+
+	/* Nothing is iterating, so rebuild the buckets in one go. Items are
+	 * visited in ascending order, so they are always appended to a bucket. */
+	this->buckets.clear();
+	for (ScriptListMap::iterator iter = this->items.begin(); iter != this->items.end(); iter++) {
+		(*iter).second = *value++;
+		ScriptItemList &bucket = this->buckets[(*iter).second];
+		bucket.insert(bucket.end(), (*iter).first);
+	}
+}
+
 void ScriptList::Sort(SorterType sorter, bool ascending)
 {
 	this->modifications++;
@@ -590,40 +634,29 @@ void ScriptList::RemoveAboveValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.upper_bound(value), this->buckets.end());
 }
 
 void ScriptList::RemoveBelowValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second < value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.begin(), this->buckets.lower_bound(value));
 }
 
 void ScriptList::RemoveBetweenValue(int64 start, int64 end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second > start && (*iter).second < end) this->RemoveItem((*iter).first);
-	}
+	if (start >= end) return;
+	this->RemoveItems(this->buckets.upper_bound(start), this->buckets.lower_bound(end));
 }
 
 void ScriptList::RemoveValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second == value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.lower_bound(value), this->buckets.upper_bound(value));
 }
 
 void ScriptList::RemoveTop(int32 count)
@@ -718,40 +751,30 @@ void ScriptList::KeepAboveValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.begin(), this->buckets.upper_bound(value));
 }
 
 void ScriptList::KeepBelowValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second >= value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.lower_bound(value), this->buckets.end());
 }
 
 void ScriptList::KeepBetweenValue(int64 start, int64 end)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second <= start || (*iter).second >= end) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.begin(), this->buckets.upper_bound(start));
+	this->RemoveItems(this->buckets.lower_bound(end), this->buckets.end());
 }
 
 void ScriptList::KeepValue(int64 value)
 {
 	this->modifications++;
 
-	for (ScriptListMap::iterator next_iter, iter = this->items.begin(); iter != this->items.end(); iter = next_iter) {
-		next_iter = iter; next_iter++;
-		if ((*iter).second != value) this->RemoveItem((*iter).first);
-	}
+	this->RemoveItems(this->buckets.begin(), this->buckets.lower_bound(value));
+	this->RemoveItems(this->buckets.upper_bound(value), this->buckets.end());
 }
 
 void ScriptList::KeepTop(int32 count)
@@ -14,6 +14,7 @@
 #include "script_object.hpp"
 #include <map>
 #include <set>
+#include <vector>
 
 class ScriptListSorter;
 
@@ -286,6 +287,26 @@ public:
 	 */
 	void Valuate(void *valuator_function, int params, ...);
 #endif /* DOXYGEN_API */
+
+protected:
+	/**
+	 * Give all items a value computed in C++, without calling back into
+	 * the script for every item like Valuate() does.
+	 * @param valuator Callable that returns the new value for a given item.
+	 */
+	template <typename Tvaluator>
+	void ValuateNative(Tvaluator valuator)
+	{
+		std::vector<int64> values;
+		values.reserve(this->items.size());
+		for (const auto &item : this->items) values.push_back(valuator(item.first));
+		ScriptObject::DecreaseOps((int)values.size());
+		this->SetAllValues(values);
+	}
+
+private:
+	void SetAllValues(const std::vector<int64> &values);
+	void RemoveItems(ScriptListBucket::iterator begin, ScriptListBucket::iterator end);
 };
 
 #endif /* SCRIPT_LIST_HPP */
@@ -269,6 +269,11 @@ ScriptObject::ActiveInstance::~ActiveInstance()
 	return GetStorage()->allow_do_command && squirrel->CanSuspend();
 }
 
+/* static */ void ScriptObject::DecreaseOps(int ops)
+{
+	Squirrel::DecreaseOps(ScriptObject::GetActiveInstance()->engine->GetVM(), ops);
+}
+
 /* static */ void *&ScriptObject::GetEventPointer()
 {
 	return GetStorage()->event_data;
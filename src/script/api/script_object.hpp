@@ -247,6 +247,12 @@ protected:
 	 */
 	static bool CanSuspend();
 
+	/**
+	 * Charge the script for work done natively on its behalf.
+	 * @param ops The amount of operations to deduct.
+	 */
+	static void DecreaseOps(int ops);
+
 	/**
 	 * Get the pointer to store event data in.
 	 */
@@ -10,6 +10,7 @@
 #include "../../stdafx.h"
 #include "script_tilelist.hpp"
 #include "script_industry.hpp"
+#include "script_tile.hpp"
 #include "../../industry.h"
 #include "../../station_base.h"
 
@@ -47,6 +48,26 @@ void ScriptTileList::RemoveTile(TileIndex tile)
 	this->RemoveItem(tile);
 }
 
+void ScriptTileList::ValuateBuildable()
+{
+	this->ValuateNative([](int64 tile) -> int64 { return ScriptTile::IsBuildable((TileIndex)tile) ? 1 : 0; });
+}
+
+void ScriptTileList::ValuateSlope()
+{
+	this->ValuateNative([](int64 tile) -> int64 { return ScriptTile::GetSlope((TileIndex)tile); });
+}
+
+void ScriptTileList::ValuateDistanceManhattanToTile(TileIndex tile)
+{
+	this->ValuateNative([tile](int64 item) -> int64 { return ScriptTile::GetDistanceManhattanToTile((TileIndex)item, tile); });
+}
+
+void ScriptTileList::ValuateDistanceSquareToTile(TileIndex tile)
+{
+	this->ValuateNative([tile](int64 item) -> int64 { return ScriptTile::GetDistanceSquareToTile((TileIndex)item, tile); });
+}
+
 /**
  * Helper to get list of tiles that will cover an industry's production or acceptance.
  * @param i Industry in question
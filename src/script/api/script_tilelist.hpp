@@ -51,6 +51,36 @@ public:
 	 * @pre ScriptMap::IsValidTile(tile).
 	 */
 	void RemoveTile(TileIndex tile);
+
+	/**
+	 * Give every tile in the list the value of ScriptTile::IsBuildable.
+	 * @note This gives the same result as Valuate(ScriptTile.IsBuildable), but
+	 *  without calling back into the script for every tile.
+	 */
+	void ValuateBuildable();
+
+	/**
+	 * Give every tile in the list the value of ScriptTile::GetSlope.
+	 * @note This gives the same result as Valuate(ScriptTile.GetSlope), but
+	 *  without calling back into the script for every tile.
+	 */
+	void ValuateSlope();
+
+	/**
+	 * Give every tile in the list its Manhattan distance to the given tile.
+	 * @param tile The tile to get the distance to.
+	 * @note This gives the same result as Valuate(ScriptTile.GetDistanceManhattanToTile, tile),
+	 *  but without calling back into the script for every tile.
+	 */
+	void ValuateDistanceManhattanToTile(TileIndex tile);
+
+	/**
+	 * Give every tile in the list its square distance to the given tile.
+	 * @param tile The tile to get the distance to.
+	 * @note This gives the same result as Valuate(ScriptTile.GetDistanceSquareToTile, tile),
+	 *  but without calling back into the script for every tile.
+	 */
+	void ValuateDistanceSquareToTile(TileIndex tile);
 };
 
 /**
@@ -18,6 +18,22 @@
 
 #include "../../safeguards.h"
 
+/**
+ * Add the vehicles sharing an order list to a script list.
+ * @param list The list to add the vehicles to.
+ * @param orders The order list.
+ * @param type The type of vehicles to add, or #VEH_INVALID for all types.
+ * @param company The company the vehicles must belong to, or #OWNER_DEITY for all companies.
+ */
+static void AddOrderListVehicles(ScriptList *list, const OrderList *orders, VehicleType type, CompanyID company)
+{
+	for (const Vehicle *v = orders->GetFirstSharedVehicle(); v != nullptr; v = v->NextShared()) {
+		if ((v->owner == company || company == OWNER_DEITY) && v->IsPrimaryVehicle() && (type == VEH_INVALID || v->type == type)) {
+			list->AddItem(v->index);
+		}
+	}
+}
+
 ScriptVehicleList::ScriptVehicleList()
 {
 	for (const Vehicle *v : Vehicle::Iterate()) {
@@ -29,13 +45,11 @@ ScriptVehicleList_Station::ScriptVehicleList_Station(StationID station_id)
 {
 	if (!ScriptBaseStation::IsValidBaseStation(station_id)) return;
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if ((v->owner == ScriptObject::GetCompany() || ScriptObject::GetCompany() == OWNER_DEITY) && v->IsPrimaryVehicle()) {
-			for (const Order *order : v->Orders()) {
-				if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT)) && order->GetDestination() == station_id) {
-					this->AddItem(v->index);
-					break;
-				}
+	for (const OrderList *orders : OrderList::GetByDestination(OT_GOTO_STATION, station_id)) {
+		for (const Order *order = orders->GetFirstOrder(); order != nullptr; order = order->next) {
+			if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT)) && order->GetDestination() == station_id) {
+				AddOrderListVehicles(this, orders, VEH_INVALID, ScriptObject::GetCompany());
+				break;
 			}
 		}
 	}
@@ -77,13 +91,11 @@ ScriptVehicleList_Depot::ScriptVehicleList_Depot(TileIndex tile)
 			return;
 	}
 
-	for (const Vehicle *v : Vehicle::Iterate()) {
-		if ((v->owner == ScriptObject::GetCompany() || ScriptObject::GetCompany() == OWNER_DEITY) && v->IsPrimaryVehicle() && v->type == type) {
-			for (const Order *order : v->Orders()) {
-				if (order->IsType(OT_GOTO_DEPOT) && order->GetDestination() == dest) {
-					this->AddItem(v->index);
-					break;
-				}
+	for (const OrderList *orders : OrderList::GetByDestination(OT_GOTO_DEPOT, dest)) {
+		for (const Order *order = orders->GetFirstOrder(); order != nullptr; order = order->next) {
+			if (order->IsType(OT_GOTO_DEPOT) && order->GetDestination() == dest) {
+				AddOrderListVehicles(this, orders, type, ScriptObject::GetCompany());
+				break;
 			}
 		}
 	}
@@ -39,6 +39,10 @@
 struct ScriptAllocator {
 	size_t allocated_size;   ///< Sum of allocated data size
 	size_t allocation_limit; ///< Maximum this allocator may use before allocations fail
+	size_t peak_size;        ///< Highest value allocated_size has reached
+	size_t system_size;      ///< Sum of the sizes of the allocations passed on to the system allocator
+	size_t pooled_allocations; ///< Number of allocations served from the size class pools
+	size_t system_allocations; ///< Number of allocations passed on to the system allocator
 	/**
 	 * Whether the error has already been thrown, so to not throw secondary errors in
 	 * the handling of the allocation error. This as the handling of the error will
@@ -49,13 +53,46 @@ struct ScriptAllocator {
 
 	static const size_t SAFE_LIMIT = 0x8000000; ///< 128 MiB, a safe choice for almost any situation
 
+	static const size_t SIZE_CLASS_GRANULARITY = 16; ///< Difference in size between two size classes; also the alignment of pooled blocks
+	static const size_t SIZE_CLASS_COUNT = 16;       ///< Number of size classes; larger allocations go to the system allocator
+	static const size_t MAX_POOLED_SIZE = SIZE_CLASS_GRANULARITY * SIZE_CLASS_COUNT; ///< Largest allocation served from the pools
+	static const size_t CHUNK_SIZE = 16 * 1024;      ///< Size of the chunks the pools are carved from
+
+	/** Header of a free block in the pools. */
+	struct FreeBlock {
+		FreeBlock *next; ///< Next free block of the same size class.
+	};
+
+	/** A chunk the blocks of one size class are carved from. */
+	struct Chunk {
+		char *begin;       ///< Start of the chunk's memory.
+		size_t size_class; ///< The size class of all blocks in the chunk.
+
+		bool operator<(const Chunk &other) const { return this->begin < other.begin; }
+	};
+
+	FreeBlock *free_blocks[SIZE_CLASS_COUNT]; ///< Free list per size class
+	std::vector<Chunk> chunks;                ///< Chunks owned by the pools, sorted by address
+	char *chunk_pos[SIZE_CLASS_COUNT];        ///< Per size class, the first unused byte in its newest chunk
+	char *chunk_end[SIZE_CLASS_COUNT];        ///< Per size class, the end of its newest chunk
+
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 	std::map<void *, size_t> allocations;
 #endif
 
+	/**
+	 * Get the memory this allocator really holds: the system allocations and all
+	 * chunks of the pools, whether their blocks are in use or not.
+	 * @return The amount of bytes held.
+	 */
+	size_t GetFootprint() const
+	{
+		return this->system_size + this->chunks.size() * CHUNK_SIZE;
+	}
+
 	void CheckLimit() const
 	{
-		if (this->allocated_size > this->allocation_limit) throw Script_FatalError("Maximum memory allocation exceeded");
+		if (this->GetFootprint() > this->allocation_limit) throw Script_FatalError("Maximum memory allocation exceeded");
 	}
 
 	/**
@@ -69,14 +106,14 @@ struct ScriptAllocator {
 	 */
 	void CheckAllocation(size_t requested_size, const void *p)
 	{
-		if (this->allocated_size > this->allocation_limit && !this->error_thrown) {
+		if (this->GetFootprint() > this->allocation_limit && !this->error_thrown) {
 			/* Do not allow allocating more than the allocation limit, except when an error is
 			 * already as then the allocation is for throwing that error in Squirrel, the
 			 * associated stack trace information and while cleaning up the AI. */
 			this->error_thrown = true;
 			char buff[128];
 			seprintf(buff, lastof(buff), "Maximum memory allocation exceeded by " PRINTF_SIZE " bytes when allocating " PRINTF_SIZE " bytes",
-				this->allocated_size - this->allocation_limit, requested_size);
+				this->GetFootprint() - this->allocation_limit, requested_size);
 			throw Script_FatalError(buff);
 		}
 
@@ -97,10 +134,97 @@ struct ScriptAllocator {
 		}
 	}
 
+	/**
+	 * Get the size class an allocation falls in.
+	 * @param size The size of the allocation, at most MAX_POOLED_SIZE.
+	 * @return The size class.
+	 */
+	static inline size_t GetSizeClass(size_t size)
+	{
+		return (size - 1) / SIZE_CLASS_GRANULARITY;
+	}
+
+	/**
+	 * Get the size class of a pooled block from the chunk it lies in.
+	 * @param p The block.
+	 * @return The size class.
+	 */
+	size_t GetBlockSizeClass(const void *p) const
+	{
+		Chunk key = { const_cast<char *>(static_cast<const char *>(p)), 0 };
+		auto it = std::upper_bound(this->chunks.begin(), this->chunks.end(), key);
+		assert(it != this->chunks.begin());
+		--it;
+		assert(key.begin < it->begin + CHUNK_SIZE);
+		return it->size_class;
+	}
+
+	/**
+	 * Allocate memory, from the pools when it is small enough.
+	 * @param size The amount of bytes to allocate.
+	 * @return The allocated memory, or nullptr when out of memory.
+	 */
+	void *AllocateBlock(size_t size)
+	{
+		if (size == 0 || size > MAX_POOLED_SIZE) {
+			this->system_allocations++;
+			void *p = malloc(size);
+			if (p != nullptr) this->system_size += size;
+			return p;
+		}
+
+		this->pooled_allocations++;
+		size_t size_class = GetSizeClass(size);
+		FreeBlock *block = this->free_blocks[size_class];
+		if (block != nullptr) {
+			this->free_blocks[size_class] = block->next;
+			return block;
+		}
+
+		size_t block_size = (size_class + 1) * SIZE_CLASS_GRANULARITY;
+		if ((size_t)(this->chunk_end[size_class] - this->chunk_pos[size_class]) < block_size) {
+			/* The few bytes left in the current chunk of this size class are not worth keeping track of. */
+			char *chunk = static_cast<char *>(malloc(CHUNK_SIZE));
+			if (chunk == nullptr) return nullptr;
+			Chunk entry = { chunk, size_class };
+			this->chunks.insert(std::upper_bound(this->chunks.begin(), this->chunks.end(), entry), entry);
+			this->chunk_pos[size_class] = chunk;
+			this->chunk_end[size_class] = chunk + CHUNK_SIZE;
+		}
+
+		void *p = this->chunk_pos[size_class];
+		this->chunk_pos[size_class] += block_size;
+		return p;
+	}
+
+	/**
+	 * Release memory allocated by AllocateBlock.
+	 * @param p    The memory to release.
+	 * @param size The size it was allocated with.
+	 */
+	void ReleaseBlock(void *p, size_t size)
+	{
+		if (size == 0 || size > MAX_POOLED_SIZE) {
+			free(p);
+			this->system_size -= size;
+			return;
+		}
+
+		size_t size_class = GetSizeClass(size);
+#ifdef WITH_ASSERT
+		/* A wrong size would put the block in the free list of another size class. */
+		assert(this->GetBlockSizeClass(p) == size_class);
+#endif
+		FreeBlock *block = static_cast<FreeBlock *>(p);
+		block->next = this->free_blocks[size_class];
+		this->free_blocks[size_class] = block;
+	}
+
 	void *Malloc(SQUnsignedInteger size)
 	{
-		void *p = malloc(size);
+		void *p = this->AllocateBlock(size);
 		this->allocated_size += size;
+		this->peak_size = std::max(this->peak_size, this->allocated_size);
 
 		this->CheckAllocation(size, p);
 
@@ -128,10 +252,25 @@ struct ScriptAllocator {
 		this->allocations.erase(p);
 #endif
 
-		void *new_p = realloc(p, size);
+		void *new_p;
+		if (oldsize > MAX_POOLED_SIZE && size > MAX_POOLED_SIZE) {
+			this->system_allocations++;
+			new_p = realloc(p, size);
+			if (new_p != nullptr) this->system_size += size - oldsize;
+		} else if (oldsize != 0 && oldsize <= MAX_POOLED_SIZE && size <= MAX_POOLED_SIZE && GetSizeClass(oldsize) == GetSizeClass(size)) {
+			/* The block is already large enough. */
+			new_p = p;
+		} else {
+			new_p = this->AllocateBlock(size);
+			if (new_p != nullptr) {
+				memcpy(new_p, p, std::min<size_t>(oldsize, size));
+				this->ReleaseBlock(p, oldsize);
+			}
+		}
 
 		this->allocated_size -= oldsize;
 		this->allocated_size += size;
+		this->peak_size = std::max(this->peak_size, this->allocated_size);
 
 		this->CheckAllocation(size, p);
 
@@ -147,7 +286,7 @@ struct ScriptAllocator {
 	void Free(void *p, SQUnsignedInteger size)
 	{
 		if (p == nullptr) return;
-		free(p);
+		this->ReleaseBlock(p, size);
 		this->allocated_size -= size;
 
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
@@ -162,6 +301,13 @@ struct ScriptAllocator {
 		this->allocation_limit = static_cast<size_t>(_settings_game.script.script_max_memory_megabytes) << 20;
 		if (this->allocation_limit == 0) this->allocation_limit = SAFE_LIMIT; // in case the setting is somehow zero
 		this->error_thrown = false;
+		this->peak_size = 0;
+		this->system_size = 0;
+		this->pooled_allocations = 0;
+		this->system_allocations = 0;
+		std::fill(std::begin(this->free_blocks), std::end(this->free_blocks), nullptr);
+		std::fill(std::begin(this->chunk_pos), std::end(this->chunk_pos), nullptr);
+		std::fill(std::begin(this->chunk_end), std::end(this->chunk_end), nullptr);
 	}
 
 	~ScriptAllocator()
@@ -169,6 +315,8 @@ struct ScriptAllocator {
 #ifdef SCRIPT_DEBUG_ALLOCATIONS
 		assert(this->allocations.size() == 0);
 #endif
+		/* Every pooled block lives in one of the chunks, so this releases them all at once. */
+		for (const Chunk &chunk : this->chunks) free(chunk.begin);
 	}
 };
 
@@ -758,6 +906,10 @@ void Squirrel::Uninitialize()
 	/* Clean up the stuff */
 	sq_pop(this->vm, 1);
 	sq_close(this->vm);
+
+	const ScriptAllocator *allocator = this->allocator.get();
+	DEBUG(script, 3, "%s memory: peak " PRINTF_SIZE " bytes, " PRINTF_SIZE " pooled and " PRINTF_SIZE " system allocations, " PRINTF_SIZE " bytes in pool chunks",
+		this->APIName, allocator->peak_size, allocator->pooled_allocations, allocator->system_allocations, allocator->chunks.size() * ScriptAllocator::CHUNK_SIZE);
 }
 
 void Squirrel::Reset()
@@ -16,6 +16,8 @@
 #include "train.h"
 #include "company_base.h"
 
+#include <unordered_map>
+
 #include "safeguards.h"
 
 
@@ -24,6 +26,7 @@ static const uint SIG_TBU_SIZE    =  64; ///< number of signals entering to bloc
 static const uint SIG_TBD_SIZE    = 256; ///< number of intersections - open nodes in current block
 static const uint SIG_GLOB_SIZE   = 128; ///< number of open blocks (block can be opened more times until detected)
 static const uint SIG_GLOB_UPDATE =  64; ///< how many items need to be in _globset to force update
+static const uint SIG_BLOCK_CACHE_SIZE = 16384; ///< number of explored blocks that are remembered
 
 static_assert(SIG_GLOB_UPDATE <= SIG_GLOB_SIZE);
 
@@ -187,6 +190,70 @@ static SmallSet<DiagDirection, SIG_TBD_SIZE> _tbdset("_tbdset");    ///< set of
 static SmallSet<DiagDirection, SIG_GLOB_SIZE> _globset("_globset"); ///< set of places to be updated in following runs
 
 
+/** Where the exploration of a signal block starts; the one or two items put into _tbdset. */
+struct SignalBlockStart {
+	TileIndex tile[2];      ///< start tiles, the second one INVALID_TILE when there is only one
+	DiagDirection dir[2];   ///< start directions
+	Owner owner;            ///< owner whose signals are updated
+
+	bool operator==(const SignalBlockStart &other) const
+	{
+		return this->tile[0] == other.tile[0] && this->tile[1] == other.tile[1] &&
+				this->dir[0] == other.dir[0] && this->dir[1] == other.dir[1] && this->owner == other.owner;
+	}
+};
+
+/** Hash of a #SignalBlockStart. */
+struct SignalBlockStartHash {
+	size_t operator()(const SignalBlockStart &start) const
+	{
+		return start.tile[0] ^ (start.tile[1] << 8) ^ (start.dir[0] << 28) ^ (start.dir[1] << 30) ^ start.owner;
+	}
+};
+
+/**
+ * What exploring a signal block finds, apart from trains and signal states.
+ * It only depends on the track layout, so replaying it is enough to update
+ * the block again until the layout changes.
+ */
+struct SignalBlock {
+	/** A place where the exploration looks for trains. */
+	struct TrainCheck {
+		TileIndex tile;   ///< the tile
+		TrackBits tracks; ///< the tracks a train has to be on, or TRACK_BIT_NONE for any train on the tile
+
+		bool operator==(const TrainCheck &other) const { return this->tile == other.tile && this->tracks == other.tracks; }
+	};
+
+	/** A signal or a side of a tile passed by the exploration. */
+	template <typename Tdir>
+	struct Item {
+		TileIndex tile; ///< the tile
+		Tdir dir;       ///< the trackdir or the side
+
+		bool operator==(const Item &other) const { return this->tile == other.tile && this->dir == other.dir; }
+	};
+
+	std::vector<TrainCheck> train_checks;        ///< places to look for trains, in order
+	std::vector<Item<Trackdir>> signals;         ///< signals facing into the block, in the order they are updated
+	std::vector<Item<Trackdir>> exits;           ///< presignal exits leading out of the block
+	std::vector<Item<DiagDirection>> sides;      ///< sides removed from _globset, in order
+	std::vector<TileIndex> tiles;                ///< all tiles the exploration passed, each once; changing any of them may change the block
+	bool pbs = false;                            ///< whether a path signal was found
+
+	bool operator==(const SignalBlock &other) const
+	{
+		return this->train_checks == other.train_checks && this->signals == other.signals &&
+				this->exits == other.exits && this->sides == other.sides && this->pbs == other.pbs;
+	}
+};
+
+static std::unordered_map<SignalBlockStart, SignalBlock, SignalBlockStartHash> _signal_blocks; ///< blocks explored since the track layout last changed
+static std::unordered_multimap<TileIndex, SignalBlockStart> _signal_block_tiles; ///< per tile, the remembered blocks passing it
+static SignalBlock *_explored_block = nullptr; ///< block to record the exploration into, if any
+static bool _layout_changing = false;          ///< track layout is being changed; do not use nor remember explored blocks until the buffer is updated
+
+
 /** Check whether there is a train on rail, not in a depot */
 static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
 {
@@ -211,6 +278,11 @@ static Vehicle *TrainOnTileEnum(Vehicle *v, void *)
  */
 static inline bool CheckAddToTodoSet(TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
 {
+	if (_explored_block != nullptr) {
+		_explored_block->sides.push_back({t1, d1});
+		_explored_block->sides.push_back({t2, d2});
+	}
+
 	_globset.Remove(t1, d1); // it can be in Global but not in Todo
 	_globset.Remove(t2, d2); // remove in all cases
 
@@ -258,6 +330,31 @@ enum SigFlags {
 DECLARE_ENUM_AS_BIT_SET(SigFlags)
 
 
+/**
+ * Check whether there is a train on a tile of a signal block.
+ * @param tile the tile
+ * @param tracks the tracks the train has to be on, or TRACK_BIT_NONE for any train on the tile
+ * @return true iff there is such a train
+ */
+static inline bool HasTrainInBlock(TileIndex tile, TrackBits tracks)
+{
+	if (tracks == TRACK_BIT_NONE) return HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum);
+	return EnsureNoTrainOnTrackBits(tile, tracks).Failed();
+}
+
+/**
+ * Look for trains on a tile while exploring a signal block, unless one was found already.
+ * @param flags the block state flags found so far
+ * @param tile the tile
+ * @param tracks the tracks a train has to be on, or TRACK_BIT_NONE for any train on the tile
+ */
+static inline void CheckTrainInBlock(SigFlags &flags, TileIndex tile, TrackBits tracks = TRACK_BIT_NONE)
+{
+	if (_explored_block != nullptr) _explored_block->train_checks.push_back({tile, tracks});
+	if (!(flags & SF_TRAIN) && HasTrainInBlock(tile, tracks)) flags |= SF_TRAIN;
+}
+
+
 /**
  * Search signal block
  *
@@ -281,13 +378,13 @@ static SigFlags ExploreSegment(Owner owner)
 
 				if (IsRailDepot(tile)) {
 					if (enterdir == INVALID_DIAGDIR) { // from 'inside' - train just entered or left the depot
-						if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+						CheckTrainInBlock(flags, tile);
 						exitdir = GetRailDepotDirection(tile);
 						tile += TileOffsByDiagDir(exitdir);
 						enterdir = ReverseDiagDir(exitdir);
 						break;
 					} else if (enterdir == GetRailDepotDirection(tile)) { // entered a depot
-						if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+						CheckTrainInBlock(flags, tile);
 						continue;
 					} else {
 						continue;
@@ -301,10 +398,10 @@ static SigFlags ExploreSegment(Owner owner)
 				if (tracks == TRACK_BIT_HORZ || tracks == TRACK_BIT_VERT) { // there is exactly one incidating track, no need to check
 					tracks = tracks_masked;
 					/* If no train detected yet, and there is not no train -> there is a train -> set the flag */
-					if (!(flags & SF_TRAIN) && EnsureNoTrainOnTrackBits(tile, tracks).Failed()) flags |= SF_TRAIN;
+					CheckTrainInBlock(flags, tile, tracks);
 				} else {
 					if (tracks_masked == TRACK_BIT_NONE) continue; // no incidating track
-					if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+					CheckTrainInBlock(flags, tile);
 				}
 
 				if (HasSignals(tile)) { // there is exactly one track - not zero, because there is exit from this tile
@@ -321,10 +418,16 @@ static SigFlags ExploreSegment(Owner owner)
 								flags |= SF_PBS;
 							} else if (!_tbuset.Add(tile, reversedir)) {
 								return flags | SF_FULL;
+							} else if (_explored_block != nullptr) {
+								_explored_block->signals.push_back({tile, reversedir});
 							}
 						}
 						if (HasSignalOnTrackdir(tile, trackdir) && !IsOnewaySignal(tile, track)) flags |= SF_PBS;
 
+						if (_explored_block != nullptr && IsPresignalExit(tile, track) && HasSignalOnTrackdir(tile, trackdir)) {
+							_explored_block->exits.push_back({tile, trackdir});
+						}
+
 						/* if it is a presignal EXIT in OUR direction and we haven't found 2 green exits yes, do special check */
 						if (!(flags & SF_GREEN2) && IsPresignalExit(tile, track) && HasSignalOnTrackdir(tile, trackdir)) { // found presignal exit
 							if (flags & SF_EXIT) flags |= SF_EXIT2; // found two (or more) exits
@@ -356,7 +459,7 @@ static SigFlags ExploreSegment(Owner owner)
 				if (DiagDirToAxis(enterdir) != GetRailStationAxis(tile)) continue; // different axis
 				if (IsStationTileBlocked(tile)) continue; // 'eye-candy' station tile
 
-				if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+				CheckTrainInBlock(flags, tile);
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -365,7 +468,7 @@ static SigFlags ExploreSegment(Owner owner)
 				if (GetTileOwner(tile) != owner) continue;
 				if (DiagDirToAxis(enterdir) == GetCrossingRoadAxis(tile)) continue; // different axis
 
-				if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+				CheckTrainInBlock(flags, tile);
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -375,13 +478,13 @@ static SigFlags ExploreSegment(Owner owner)
 				DiagDirection dir = GetTunnelBridgeDirection(tile);
 
 				if (enterdir == INVALID_DIAGDIR) { // incoming from the wormhole
-					if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+					CheckTrainInBlock(flags, tile);
 					enterdir = dir;
 					exitdir = ReverseDiagDir(dir);
 					tile += TileOffsByDiagDir(exitdir); // just skip to next tile
 				} else { // NOT incoming from the wormhole!
 					if (ReverseDiagDir(enterdir) != dir) continue;
-					if (!(flags & SF_TRAIN) && HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum)) flags |= SF_TRAIN;
+					CheckTrainInBlock(flags, tile);
 					tile = GetOtherTunnelBridgeEnd(tile); // just skip to exit tile
 					enterdir = INVALID_DIAGDIR;
 					exitdir = INVALID_DIAGDIR;
@@ -400,6 +503,42 @@ static SigFlags ExploreSegment(Owner owner)
 }
 
 
+/**
+ * Update the state of a signal block like #ExploreSegment does, from what an
+ * earlier exploration of the block found.
+ *
+ * @param block the explored block
+ * @return SigFlags
+ */
+static SigFlags ReplaySegment(const SignalBlock &block)
+{
+	SigFlags flags = block.pbs ? SF_PBS : SF_NONE;
+
+	for (const auto &side : block.sides) _globset.Remove(side.tile, side.dir);
+
+	for (const auto &check : block.train_checks) {
+		if (HasTrainInBlock(check.tile, check.tracks)) {
+			flags |= SF_TRAIN;
+			break;
+		}
+	}
+
+	for (const auto &exit : block.exits) {
+		if (flags & SF_GREEN2) break;
+		if (flags & SF_EXIT) flags |= SF_EXIT2;
+		flags |= SF_EXIT;
+		if (GetSignalStateByTrackdir(exit.tile, exit.dir) == SIGNAL_STATE_GREEN) {
+			if (flags & SF_GREEN) flags |= SF_GREEN2;
+			flags |= SF_GREEN;
+		}
+	}
+
+	for (const auto &signal : block.signals) _tbuset.Add(signal.tile, signal.dir);
+
+	return flags;
+}
+
+
 /**
  * Update signals around segment in _tbuset
  *
@@ -460,6 +599,134 @@ static inline void ResetSets()
 }
 
 
+/**
+ * Update the state of the signal block starting at the items in _tbdset.
+ * Blocks are explored only once until the track layout changes,
+ * after that it is enough to look for trains and presignal exits again.
+ *
+ * @param owner owner whose signals we are updating
+ * @return SigFlags
+ */
+static SigFlags ExploreOrReplaySegment(Owner owner)
+{
+	if (_layout_changing) return ExploreSegment(owner);
+
+	SignalBlockStart start;
+	start.tile[1] = INVALID_TILE;
+	start.dir[1] = INVALID_DIAGDIR;
+	start.owner = owner;
+
+	uint items = _tbdset.Items();
+	for (uint i = items; i-- > 0;) _tbdset.Get(&start.tile[i], &start.dir[i]);
+
+	auto it = _signal_blocks.find(start);
+	if (it != _signal_blocks.end()) return ReplaySegment(it->second);
+
+	for (uint i = 0; i < items; i++) _tbdset.Add(start.tile[i], start.dir[i]);
+
+	if (_signal_blocks.size() >= SIG_BLOCK_CACHE_SIZE) InvalidateSignalBlockCache();
+	it = _signal_blocks.emplace(start, SignalBlock()).first;
+
+	_explored_block = &it->second;
+	SigFlags flags = ExploreSegment(owner);
+	_explored_block = nullptr;
+
+	if (flags & SF_FULL) {
+		/* the sets were too small, so the block was not explored completely */
+		_signal_blocks.erase(it);
+	} else {
+		SignalBlock &block = it->second;
+		block.pbs = (flags & SF_PBS) != 0;
+
+		/* index the block by its tiles, so changing one of them only forgets the blocks passing it */
+		for (uint i = 0; i < items; i++) block.tiles.push_back(start.tile[i]);
+		for (const auto &check : block.train_checks) block.tiles.push_back(check.tile);
+		for (const auto &signal : block.signals) block.tiles.push_back(signal.tile);
+		for (const auto &exit : block.exits) block.tiles.push_back(exit.tile);
+		for (const auto &side : block.sides) block.tiles.push_back(side.tile);
+		std::sort(block.tiles.begin(), block.tiles.end());
+		block.tiles.erase(std::unique(block.tiles.begin(), block.tiles.end()), block.tiles.end());
+		block.tiles.shrink_to_fit();
+		for (TileIndex tile : block.tiles) _signal_block_tiles.emplace(tile, start);
+	}
+
+	return flags;
+}
+
+
+/**
+ * Forget all explored signal blocks, e.g. because the owner of tracks changed.
+ */
+void InvalidateSignalBlockCache()
+{
+	_signal_blocks.clear();
+	_signal_block_tiles.clear();
+}
+
+
+/**
+ * Forget the explored signal blocks passing a tile, because the tile changes.
+ * The cost only depends on the size of these blocks, not on the number of remembered blocks.
+ *
+ * @param tile the changed tile
+ */
+void InvalidateSignalBlocks(TileIndex tile)
+{
+	static std::vector<SignalBlockStart> starts;
+
+	auto range = _signal_block_tiles.equal_range(tile);
+	if (range.first == range.second) return;
+
+	starts.clear();
+	for (auto it = range.first; it != range.second; ++it) starts.push_back(it->second);
+
+	for (const SignalBlockStart &start : starts) {
+		auto block = _signal_blocks.find(start);
+		if (block == _signal_blocks.end()) continue;
+
+		/* remove the block from the index of each of its tiles */
+		for (TileIndex t : block->second.tiles) {
+			auto tile_range = _signal_block_tiles.equal_range(t);
+			for (auto it = tile_range.first; it != tile_range.second; ++it) {
+				if (it->second == start) {
+					_signal_block_tiles.erase(it);
+					break;
+				}
+			}
+		}
+		_signal_blocks.erase(block);
+	}
+}
+
+
+/**
+ * Check whether the remembered signal blocks still match the track layout.
+ * @return true iff exploring the blocks again finds the same as before
+ * @pre the signal update buffer is empty
+ */
+bool CheckSignalBlockCache()
+{
+	assert(_globset.IsEmpty());
+
+	bool result = true;
+	for (const auto &it : _signal_blocks) {
+		const SignalBlockStart &start = it.first;
+		for (uint i = 0; i < 2 && start.tile[i] != INVALID_TILE; i++) _tbdset.Add(start.tile[i], start.dir[i]);
+
+		SignalBlock block;
+		_explored_block = &block;
+		SigFlags flags = ExploreSegment(start.owner);
+		_explored_block = nullptr;
+		block.pbs = (flags & SF_PBS) != 0;
+
+		ResetSets();
+		if ((flags & SF_FULL) || !(block == it.second)) result = false;
+	}
+
+	return result;
+}
+
+
 /**
  * Updates blocks in _globset buffer
  *
@@ -529,7 +796,7 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 		assert(!_tbdset.Overflowed()); // it really shouldn't overflow by these one or two items
 		assert(!_tbdset.IsEmpty()); // it wouldn't hurt anyone, but shouldn't happen too
 
-		SigFlags flags = ExploreSegment(owner);
+		SigFlags flags = ExploreOrReplaySegment(owner);
 
 		if (first) {
 			first = false;
@@ -567,32 +834,29 @@ void UpdateSignalsInBuffer()
 		UpdateSignalsInBuffer(_last_owner);
 		_last_owner = INVALID_OWNER; // invalidate
 	}
+
+	/* the track layout is final now, explored blocks can be remembered again */
+	_layout_changing = false;
 }
 
 
 /**
- * Add track to signal update buffer
+ * Add sides of a tile to the signal update buffer, updating the buffer when it is full
  *
  * @param tile tile where we start
- * @param track track at which ends we will update signals
+ * @param side1 first side of tile
+ * @param side2 second side of tile, or INVALID_DIAGDIR
  * @param owner owner whose signals we will update
  */
-void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner)
+static void AddSidesToGlobalSet(TileIndex tile, DiagDirection side1, DiagDirection side2, Owner owner)
 {
-	static const DiagDirection _search_dir_1[] = {
-		DIAGDIR_NE, DIAGDIR_SE, DIAGDIR_NE, DIAGDIR_SE, DIAGDIR_SW, DIAGDIR_SE
-	};
-	static const DiagDirection _search_dir_2[] = {
-		DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_NW, DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_NE
-	};
-
 	/* do not allow signal updates for two companies in one run */
 	assert(_globset.IsEmpty() || owner == _last_owner);
 
 	_last_owner = owner;
 
-	_globset.Add(tile, _search_dir_1[track]);
-	_globset.Add(tile, _search_dir_2[track]);
+	_globset.Add(tile, side1);
+	if (side2 != INVALID_DIAGDIR) _globset.Add(tile, side2);
 
 	if (_globset.Items() >= SIG_GLOB_UPDATE) {
 		/* too many items, force update */
@@ -603,26 +867,66 @@ void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner)
 
 
 /**
- * Add side of tile to signal update buffer
+ * Notify that the track layout is going to change, so explored signal blocks
+ * can not be reused until the signal update buffer is updated from 'outside'.
+ * The blocks passing the changed tile are forgotten; for tunnels and bridges
+ * also the blocks passing the other end.
+ *
+ * @param tile the changed tile
+ */
+static inline void StartLayoutChange(TileIndex tile)
+{
+	_layout_changing = true;
+	InvalidateSignalBlocks(tile);
+	if (IsTileType(tile, MP_TUNNELBRIDGE)) InvalidateSignalBlocks(GetOtherTunnelBridgeEnd(tile));
+}
+
+
+/**
+ * Add both ends of a track to the signal update buffer, without changing the track layout
  *
  * @param tile tile where we start
- * @param side side of tile
+ * @param track track at which ends we will update signals
  * @param owner owner whose signals we will update
  */
-void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner)
+static void AddTrackToGlobalSet(TileIndex tile, Track track, Owner owner)
 {
-	/* do not allow signal updates for two companies in one run */
-	assert(_globset.IsEmpty() || owner == _last_owner);
+	static const DiagDirection _search_dir_1[] = {
+		DIAGDIR_NE, DIAGDIR_SE, DIAGDIR_NE, DIAGDIR_SE, DIAGDIR_SW, DIAGDIR_SE
+	};
+	static const DiagDirection _search_dir_2[] = {
+		DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_NW, DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_NE
+	};
 
-	_last_owner = owner;
+	AddSidesToGlobalSet(tile, _search_dir_1[track], _search_dir_2[track], owner);
+}
 
-	_globset.Add(tile, side);
 
-	if (_globset.Items() >= SIG_GLOB_UPDATE) {
-		/* too many items, force update */
-		UpdateSignalsInBuffer(_last_owner);
-		_last_owner = INVALID_OWNER;
-	}
+/**
+ * Add track to signal update buffer
+ *
+ * @param tile tile where we start
+ * @param track track at which ends we will update signals
+ * @param owner owner whose signals we will update
+ */
+void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner)
+{
+	StartLayoutChange(tile);
+	AddTrackToGlobalSet(tile, track, owner);
+}
+
+
+/**
+ * Add side of tile to signal update buffer
+ *
+ * @param tile tile where we start
+ * @param side side of tile
+ * @param owner owner whose signals we will update
+ */
+void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner)
+{
+	StartLayoutChange(tile);
+	AddSidesToGlobalSet(tile, side, INVALID_DIAGDIR, owner);
 }
 
 /**
@@ -657,6 +961,6 @@ void SetSignalsOnBothDir(TileIndex tile, Track track, Owner owner)
 {
 	assert(_globset.IsEmpty());
 
-	AddTrackToSignalBuffer(tile, track, owner);
+	AddTrackToGlobalSet(tile, track, owner);
 	UpdateSignalsInBuffer(owner);
 }
@@ -57,5 +57,8 @@ void SetSignalsOnBothDir(TileIndex tile, Track track, Owner owner);
 void AddTrackToSignalBuffer(TileIndex tile, Track track, Owner owner);
 void AddSideToSignalBuffer(TileIndex tile, DiagDirection side, Owner owner);
 void UpdateSignalsInBuffer();
+void InvalidateSignalBlockCache();
+void InvalidateSignalBlocks(TileIndex tile);
+bool CheckSignalBlockCache();
 
 #endif /* SIGNAL_FUNC_H */
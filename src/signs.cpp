@@ -45,13 +45,15 @@ Sign::~Sign()
 void Sign::UpdateVirtCoord()
 {
 	Point pt = RemapCoords(this->x, this->y, this->z);
+	pt.y -= 6 * ZOOM_LVL_BASE;
 
-	if (this->sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeSign(this->index));
+	bool moved = !this->sign.IsInKdtreeAt(pt.x, pt.y);
+	if (moved && this->sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeSign(this->index));
 
 	SetDParam(0, this->index);
-	this->sign.UpdatePosition(pt.x, pt.y - 6 * ZOOM_LVL_BASE, STR_WHITE_SIGN);
+	this->sign.UpdatePosition(pt.x, pt.y, STR_WHITE_SIGN);
 
-	_viewport_sign_kdtree.Insert(ViewportSignKdtreeItem::MakeSign(this->index));
+	if (moved) _viewport_sign_kdtree.Insert(ViewportSignKdtreeItem::MakeSign(this->index));
 }
 
 /** Update the coordinates of all signs */
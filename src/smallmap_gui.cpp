@@ -163,11 +163,63 @@ static bool _smallmap_industry_highlight_state;
 /** For connecting company ID to position in owner list (small map legend) */
 static uint _company_to_list_pos[MAX_COMPANIES];
 
+/** Number of bits of the tile coordinates that are within one block of tiles of the colour cache. */
+static const uint SMALLMAP_CACHE_BLOCK_BITS = 3;
+/** Generation of the colour cache of the smallmap; incremented each time a smallmap is drawn. */
+static uint32 _smallmap_cache_generation = 0;
+/** Generation in which all colours cached by the smallmap became invalid. */
+static uint32 _smallmap_cache_invalidated = 0;
+/** Per block of tiles the generation in which a tile in it last changed; empty when no smallmap caches colours. */
+static std::vector<uint32> _smallmap_cache_block_changes;
+
+/**
+ * Invalidate the colours the smallmap cached for all tiles, e.g. because the legends changed.
+ */
+void InvalidateSmallMapColourCache()
+{
+	_smallmap_cache_invalidated = _smallmap_cache_generation;
+}
+
+/**
+ * Invalidate the colours the smallmap cached for a tile, because the tile changed.
+ * @param tile The changed tile.
+ */
+void InvalidateSmallMapColourCache(TileIndex tile)
+{
+	if (_smallmap_cache_block_changes.empty()) return;
+
+	size_t block = (TileY(tile) >> SMALLMAP_CACHE_BLOCK_BITS) * (MapSizeX() >> SMALLMAP_CACHE_BLOCK_BITS) + (TileX(tile) >> SMALLMAP_CACHE_BLOCK_BITS);
+	if (block < _smallmap_cache_block_changes.size()) _smallmap_cache_block_changes[block] = _smallmap_cache_generation;
+}
+
+/**
+ * Check whether any tile of an area changed since colours were cached for it.
+ * @param ta Tile area to check.
+ * @param generation Generation in which the colours of the area were cached.
+ * @return True iff the cached colours of the area may be outdated.
+ */
+static bool SmallMapAreaChangedSince(const TileArea &ta, uint32 generation)
+{
+	if (generation <= _smallmap_cache_invalidated) return true;
+
+	uint blocks_x = MapSizeX() >> SMALLMAP_CACHE_BLOCK_BITS;
+	uint bx_end = (TileX(ta.tile) + ta.w - 1) >> SMALLMAP_CACHE_BLOCK_BITS;
+	uint by_end = (TileY(ta.tile) + ta.h - 1) >> SMALLMAP_CACHE_BLOCK_BITS;
+	for (uint by = TileY(ta.tile) >> SMALLMAP_CACHE_BLOCK_BITS; by <= by_end; by++) {
+		for (uint bx = TileX(ta.tile) >> SMALLMAP_CACHE_BLOCK_BITS; bx <= bx_end; bx++) {
+			if (_smallmap_cache_block_changes[by * blocks_x + bx] >= generation) return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Fills an array for the industries legends.
  */
 void BuildIndustriesLegend()
 {
+	InvalidateSmallMapColourCache();
+
 	uint j = 0;
 
 	/* Add each name */
@@ -198,6 +250,8 @@ void BuildIndustriesLegend()
  */
 void BuildLinkStatsLegend()
 {
+	InvalidateSmallMapColourCache();
+
 	/* Clear the legend */
 	memset(_legend_linkstats, 0, sizeof(_legend_linkstats));
 
@@ -274,6 +328,8 @@ static SmallMapColourScheme _heightmap_schemes[] = {
  */
 void BuildLandLegend()
 {
+	InvalidateSmallMapColourCache();
+
 	/* The smallmap window has never been initialized, so no need to change the legend. */
 	if (_heightmap_schemes[0].height_colours == nullptr) return;
 
@@ -325,6 +381,8 @@ void BuildLandLegend()
  */
 void BuildOwnerLegend()
 {
+	InvalidateSmallMapColourCache();
+
 	_legend_land_owners[1].colour = _heightmap_schemes[_settings_client.gui.smallmap_land_colour].default_colour;
 
 	int i = NUM_NO_COMPANY_ENTRIES;
@@ -820,6 +878,27 @@ inline uint32 SmallMapWindow::GetTileColours(const TileArea &ta) const
 	}
 }
 
+/**
+ * Decide which colours to show to the user for a group of tiles, reusing the
+ * colours of an earlier drawing when none of the tiles changed since.
+ * @param ta Tile area to investigate.
+ * @return Colours to display.
+ */
+inline uint32 SmallMapWindow::GetCachedTileColours(const TileArea &ta) const
+{
+	/* Small areas are looked at quicker than they are looked up, and the blinking highlight changes the colours without changing tiles. */
+	if (this->zoom < MIN_CACHED_ZOOM || _smallmap_industry_highlight != INVALID_INDUSTRYTYPE) return this->GetTileColours(ta);
+
+	CachedTileColours &cached = this->colour_cache[ta.tile];
+	if (cached.w != ta.w || cached.h != ta.h || SmallMapAreaChangedSince(ta, cached.generation)) {
+		cached.colours = this->GetTileColours(ta);
+		cached.generation = _smallmap_cache_generation;
+		cached.w = ta.w;
+		cached.h = ta.h;
+	}
+	return cached.colours;
+}
+
 /**
  * Draws one column of tiles of the small map in a certain mode onto the screen buffer, skipping the shifted rows in between.
  *
@@ -857,7 +936,7 @@ void SmallMapWindow::DrawSmallMapColumn(void *dst, uint xc, uint yc, int pitch,
 		}
 		ta.ClampToMap(); // Clamp to map boundaries (may contain MP_VOID tiles!).
 
-		uint32 val = this->GetTileColours(ta);
+		uint32 val = this->GetCachedTileColours(ta);
 		uint8 *val8 = (uint8 *)&val;
 		int idx = std::max(0, -start_pos);
 		for (int pos = std::max(0, start_pos); pos < end_pos; pos++) {
@@ -974,6 +1053,12 @@ void SmallMapWindow::DrawSmallMap(DrawPixelInfo *dpi) const
 	old_dpi = _cur_dpi;
 	_cur_dpi = dpi;
 
+	/* Start a new generation of cached colours; tiles changed from now on invalidate the colours cached by this drawing. */
+	_smallmap_cache_generation++;
+	size_t blocks = (MapSizeX() >> SMALLMAP_CACHE_BLOCK_BITS) * (MapSizeY() >> SMALLMAP_CACHE_BLOCK_BITS);
+	if (_smallmap_cache_block_changes.size() != blocks) _smallmap_cache_block_changes.assign(blocks, _smallmap_cache_generation);
+	if (this->colour_cache.size() > MAX_CACHED_AREAS) this->colour_cache.clear();
+
 	/* Clear it */
 	GfxFillRect(dpi->left, dpi->top, dpi->left + dpi->width - 1, dpi->top + dpi->height - 1, PC_BLACK);
 
@@ -1312,6 +1397,7 @@ void SmallMapWindow::SwitchMapType(SmallMapType map_type)
 
 	if (map_type == SMT_LINKSTATS) this->overlay->SetDirty();
 	if (map_type != SMT_INDUSTRY) this->BreakIndustryChainLink();
+	InvalidateSmallMapColourCache();
 	this->SetDirty();
 }
 
@@ -1488,6 +1574,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 						this->SelectLegendItem(click_pos, _legend_land_owners, _smallmap_company_count, NUM_NO_COMPANY_ENTRIES);
 					}
 				}
+				InvalidateSmallMapColourCache();
 				this->SetDirty();
 			}
 			break;
@@ -1513,6 +1600,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 				tbl->show_on_map = (widget == WID_SM_ENABLE_ALL);
 			}
 			if (this->map_type == SMT_LINKSTATS) this->SetOverlayCargoMask();
+			InvalidateSmallMapColourCache();
 			this->SetDirty();
 			break;
 		}
@@ -1520,6 +1608,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 		case WID_SM_SHOW_HEIGHT: // Enable/disable showing of heightmap.
 			_smallmap_show_heightmap = !_smallmap_show_heightmap;
 			this->SetWidgetLoweredState(WID_SM_SHOW_HEIGHT, _smallmap_show_heightmap);
+			InvalidateSmallMapColourCache();
 			this->SetDirty();
 			break;
 	}
@@ -1559,6 +1648,7 @@ int SmallMapWindow::GetPositionOnLegend(Point pt)
 
 		default: NOT_REACHED();
 	}
+	InvalidateSmallMapColourCache();
 	this->SetDirty();
 }
 
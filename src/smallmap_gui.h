@@ -18,6 +18,7 @@
 #include "linkgraph/linkgraph_gui.h"
 #include "widgets/smallmap_widget.h"
 #include "guitimer_func.h"
+#include <unordered_map>
 
 /* set up the cargos to be displayed in the smallmap's route legend */
 void BuildLinkStatsLegend();
@@ -26,6 +27,8 @@ void BuildIndustriesLegend();
 void ShowSmallMap();
 void BuildLandLegend();
 void BuildOwnerLegend();
+void InvalidateSmallMapColourCache();
+void InvalidateSmallMapColourCache(TileIndex tile);
 
 /** Structure for holding relevant data for legends in small map */
 struct LegendAndColour {
@@ -67,6 +70,16 @@ protected:
 	static const uint INDUSTRY_MIN_NUMBER_OF_COLUMNS = 2; ///< Minimal number of columns in the #WID_SM_LEGEND widget for the #SMT_INDUSTRY legend.
 	static const uint FORCE_REFRESH_PERIOD = 930; ///< map is redrawn after that many milliseconds.
 	static const uint BLINK_PERIOD         = 450; ///< highlight blinking interval in milliseconds.
+	static const int MIN_CACHED_ZOOM       = 4;      ///< Minimal zoom level at which the colours of tile areas are cached.
+	static const size_t MAX_CACHED_AREAS   = 1 << 20; ///< Number of cached tile areas after which the cache is emptied.
+
+	/** Colours of a tile area as cached by #GetCachedTileColours. */
+	struct CachedTileColours {
+		uint32 colours;    ///< Colours of the tile area.
+		uint32 generation; ///< Generation of the colour cache in which the colours were determined.
+		uint16 w;          ///< Width of the tile area.
+		uint16 h;          ///< Height of the tile area.
+	};
 
 	uint min_number_of_columns;    ///< Minimal number of columns in legends.
 	uint min_number_of_fixed_rows; ///< Minimal number of rows in the legends for the fixed layouts only (all except #SMT_INDUSTRY).
@@ -80,6 +93,7 @@ protected:
 
 	GUITimer refresh; ///< Refresh timer.
 	LinkGraphOverlay *overlay;
+	mutable std::unordered_map<TileIndex, CachedTileColours> colour_cache; ///< Colours of drawn tile areas by their northern tile.
 
 	static void BreakIndustryChainLink();
 	Point SmallmapRemapCoords(int x, int y) const;
@@ -166,6 +180,7 @@ protected:
 	void SetOverlayCargoMask();
 	void SetupWidgetData();
 	uint32 GetTileColours(const TileArea &ta) const;
+	uint32 GetCachedTileColours(const TileArea &ta) const;
 
 	int GetPositionOnLegend(Point pt);
 
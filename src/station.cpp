@@ -379,7 +379,9 @@ void Station::AddIndustryToDeliver(Industry *ind)
  */
 void Station::RemoveFromAllNearbyLists()
 {
-	for (Town *t : Town::Iterate()) { t->stations_near.erase(this); }
+	for (Town *t : Town::Iterate()) {
+		if (t->stations_near.erase(this) != 0) t->stations_near_tile.clear();
+	}
 	for (Industry *i : Industry::Iterate()) { i->stations_near.erase(this); }
 }
 
@@ -451,7 +453,7 @@ void Station::RecomputeCatchment()
 	for (TileIndex tile = it; tile != INVALID_TILE; tile = ++it) {
 		if (IsTileType(tile, MP_HOUSE)) {
 			Town *t = Town::GetByTile(tile);
-			t->stations_near.insert(this);
+			if (t->stations_near.insert(this).second) t->stations_near_tile.clear();
 		}
 		if (IsTileType(tile, MP_INDUSTRY)) {
 			Industry *i = Industry::GetByTile(tile);
@@ -467,6 +469,19 @@ void Station::RecomputeCatchment()
 	}
 }
 
+/**
+ * Recompute the set of cargo types whose rating is still updated periodically,
+ * i.e. the cargo types with a rating and those recovering from a rating penalty.
+ */
+void Station::RecomputeRatedCargoes()
+{
+	this->rated_cargoes = 0;
+	for (CargoID c = 0; c < NUM_CARGO; c++) {
+		const GoodsEntry &ge = this->goods[c];
+		if (ge.HasRating() || ge.rating < INITIAL_STATION_RATING) SetBit(this->rated_cargoes, c);
+	}
+}
+
 /**
  * Recomputes catchment of all stations.
  * This will additionally recompute nearby stations for all towns and industries.
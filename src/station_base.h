@@ -478,6 +478,7 @@ public:
 	std::list<Vehicle *> loading_vehicles;
 	GoodsEntry goods[NUM_CARGO];  ///< Goods at this station
 	CargoTypes always_accepted;       ///< Bitmask of always accepted cargo types (by houses, HQs, industry tiles when industry doesn't accept cargo)
+	CargoTypes rated_cargoes;         ///< NOSAVE: Cargo types whose rating may still change, @see UpdateStationRating()
 
 	IndustryList industries_near; ///< Cached list of industries near the station that can accept cargo, @see DeliverGoodsToIndustry()
 	Industry *industry;           ///< NOSAVE: Associated industry for neutral stations. (Rebuilt on load from Industry->st)
@@ -499,6 +500,7 @@ public:
 	uint GetPlatformLength(TileIndex tile) const override;
 	void RecomputeCatchment();
 	static void RecomputeCatchmentForAll();
+	void RecomputeRatedCargoes();
 
 	uint GetCatchmentRadius() const;
 	Rect GetCatchmentRect() const;
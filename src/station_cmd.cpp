@@ -56,6 +56,7 @@
 #include "linkgraph/refresh.h"
 #include "widgets/station_widget.h"
 #include "tunnelbridge_map.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 
@@ -417,13 +418,14 @@ void Station::UpdateVirtCoord()
 	pt.y -= 32 * ZOOM_LVL_BASE;
 	if ((this->facilities & FACIL_AIRPORT) && this->airport.type == AT_OILRIG) pt.y -= 16 * ZOOM_LVL_BASE;
 
-	if (this->sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeStation(this->index));
+	bool moved = !this->sign.IsInKdtreeAt(pt.x, pt.y);
+	if (moved && this->sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeStation(this->index));
 
 	SetDParam(0, this->index);
 	SetDParam(1, this->facilities);
 	this->sign.UpdatePosition(pt.x, pt.y, STR_VIEWPORT_STATION);
 
-	_viewport_sign_kdtree.Insert(ViewportSignKdtreeItem::MakeStation(this->index));
+	if (moved) _viewport_sign_kdtree.Insert(ViewportSignKdtreeItem::MakeStation(this->index));
 
 	SetWindowDirty(WC_STATION_VIEW, this->index);
 }
@@ -1948,6 +1950,7 @@ CommandCost CmdBuildRoadStop(TileIndex tile, DoCommandFlag flags, uint32 p1, uin
 			Company::Get(st->owner)->infrastructure.station++;
 
 			MarkTileDirtyByTile(cur_tile);
+			YapfNotifyRoadStopChange(cur_tile, st->index);
 		}
 	}
 
@@ -2045,6 +2048,7 @@ static CommandCost RemoveRoadStop(TileIndex tile, DoCommandFlag flags)
 		}
 
 		delete cur_stop;
+		YapfNotifyRoadStopChange(tile, st->index);
 
 		/* Make sure no vehicle is going to the old roadstop */
 		for (RoadVehicle *v : RoadVehicle::Iterate()) {
@@ -2587,6 +2591,7 @@ CommandCost CmdBuildDock(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 		Company::Get(st->owner)->infrastructure.station += 2;
 
 		MakeDock(tile, st->owner, st->index, direction, wc);
+		InvalidateWaterRegion(tile + TileOffsByDiagDir(direction));
 		UpdateStationDockingTiles(st);
 
 		st->AfterStationTileSetChange(true, STATION_DOCK);
@@ -3466,8 +3471,16 @@ static void UpdateStationRating(Station *st)
 	byte_inc_sat(&st->time_since_load);
 	byte_inc_sat(&st->time_since_unload);
 
-	for (const CargoSpec *cs : CargoSpec::Iterate()) {
-		GoodsEntry *ge = &st->goods[cs->Index()];
+	CargoID c;
+	FOR_EACH_SET_CARGO_ID(c, st->rated_cargoes) {
+		const CargoSpec *cs = CargoSpec::Get(c);
+		GoodsEntry *ge = &st->goods[c];
+		if (!cs->IsValid() || (!ge->HasRating() && ge->rating >= INITIAL_STATION_RATING)) {
+			/* Nothing changes for this cargo until it gets a rating again. */
+			ClrBit(st->rated_cargoes, c);
+			continue;
+		}
+
 		/* Slowly increase the rating back to its original level in the case we
 		 *  didn't deliver cargo yet to this station. This happens when a bribe
 		 *  failed while you didn't moved that cargo yet to a station. */
@@ -3864,6 +3877,7 @@ void ModifyStationRatingAround(TileIndex tile, Owner owner, int amount, uint rad
 
 				if (ge->status != 0) {
 					ge->rating = Clamp(ge->rating + amount, 0, 255);
+					SetBit(st->rated_cargoes, i);
 				}
 			}
 		}
@@ -3904,6 +3918,7 @@ static uint UpdateStationWaiting(Station *st, CargoID type, uint amount, SourceT
 	if (!ge.HasRating()) {
 		InvalidateWindowData(WC_STATION_LIST, st->index);
 		SetBit(ge.status, GoodsEntry::GES_RATING);
+		SetBit(st->rated_cargoes, type);
 	}
 
 	TriggerStationRandomisation(st, st->xy, SRT_NEW_CARGO, type);
@@ -3963,13 +3978,6 @@ CommandCost CmdRenameStation(TileIndex tile, DoCommandFlag flags, uint32 p1, uin
 	return CommandCost();
 }
 
-static void AddNearbyStationsByCatchment(TileIndex tile, StationList *stations, StationList &nearby)
-{
-	for (Station *st : nearby) {
-		if (st->TileIsInCatchment(tile)) stations->insert(st);
-	}
-}
-
 /**
  * Run a tile loop to find stations around a tile, on demand. Cache the result for further requests
  * @return pointer to a StationList containing all stations found
@@ -3980,7 +3988,7 @@ const StationList *StationFinder::GetStations()
 		if (IsTileType(this->tile, MP_HOUSE)) {
 			/* Town nearby stations need to be filtered per tile. */
 			assert(this->w == 1 && this->h == 1);
-			AddNearbyStationsByCatchment(this->tile, &this->stations, Town::GetByTile(this->tile)->stations_near);
+			this->found = &Town::GetByTile(this->tile)->GetStationsNearTile(this->tile);
 		} else {
 			ForAllStationsAroundTiles(*this, [this](Station *st, TileIndex tile) {
 				this->stations.insert(st);
@@ -3989,7 +3997,7 @@ const StationList *StationFinder::GetStations()
 		}
 		this->tile = INVALID_TILE;
 	}
-	return &this->stations;
+	return this->found;
 }
 
 
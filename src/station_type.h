@@ -99,12 +99,13 @@ typedef std::set<Station *, StationCompare> StationList;
  */
 class StationFinder : TileArea {
 	StationList stations; ///< List of stations nearby
+	const StationList *found; ///< The stations found; either #stations or a list cached elsewhere
 public:
 	/**
 	 * Constructs StationFinder
 	 * @param area the area to search from
 	 */
-	StationFinder(const TileArea &area) : TileArea(area) {}
+	StationFinder(const TileArea &area) : TileArea(area), found(&this->stations) {}
 	const StationList *GetStations();
 };
 
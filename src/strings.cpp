@@ -193,10 +193,19 @@ struct LanguagePackDeleter {
 	}
 };
 
+/** How a string of the language pack can be formatted, see #GetStringFormatPlan. */
+enum StringFormatPlan : byte {
+	SFP_UNKNOWN,     ///< The string has not been looked at yet.
+	SFP_LITERAL,     ///< The string has no codes that need formatting, so it can be copied as is.
+	SFP_SINGLE_PASS, ///< The string only has codes that read their parameters in order, so no dry run is needed for their types.
+	SFP_FULL,        ///< The string needs the full treatment of #FormatString.
+};
+
 struct LoadedLanguagePack {
 	std::unique_ptr<LanguagePack, LanguagePackDeleter> langpack;
 
 	std::vector<char *> offsets;
+	std::vector<StringFormatPlan> plans; ///< Formatting plan of each string, determined when the string is first formatted.
 
 	std::array<uint, TEXT_TAB_END> langtab_num;   ///< Offset into langpack offs
 	std::array<uint, TEXT_TAB_END> langtab_start; ///< Offset into langpack offs
@@ -218,6 +227,47 @@ const char *GetStringPtr(StringID string)
 	}
 }
 
+/**
+ * Determine how a string of the language pack can be formatted.
+ * @param str The string.
+ * @return The formatting plan.
+ */
+static StringFormatPlan DetermineStringFormatPlan(const char *str)
+{
+	StringFormatPlan plan = SFP_LITERAL;
+	for (;;) {
+		WChar c = Utf8Consume(&str);
+		if (c == '\0') return plan;
+
+		/* Characters, sprites, colour and font codes are copied as they are. */
+		if (c < SCC_CONTROL_START || c > SCC_CONTROL_END) continue;
+		if (c >= SCC_FIRST_FONT && c <= SCC_LAST_FONT) continue;
+		if (c >= SCC_BLUE && c <= SCC_POP_COLOUR) continue;
+
+		/* These codes read their parameters in order and have no data in the string. */
+		if (c >= SCC_REVISION && c <= SCC_RAW_STRING_POINTER) {
+			plan = SFP_SINGLE_PASS;
+			continue;
+		}
+
+		/* Plurals, genders, cases and argument indices have data in the string,
+		 * and may look at the types of parameters that are only read later on. */
+		return SFP_FULL;
+	}
+}
+
+/**
+ * Get the formatting plan of a string of the language pack.
+ * @param pos Position of the string in the language pack.
+ * @return The formatting plan.
+ */
+static StringFormatPlan GetStringFormatPlan(uint pos)
+{
+	StringFormatPlan &plan = _langpack.plans[pos];
+	if (plan == SFP_UNKNOWN) plan = DetermineStringFormatPlan(_langpack.offsets[pos]);
+	return plan;
+}
+
 /**
  * Get a parsed string with most special stringcodes replaced by the string parameters.
  * @param buffr  Pointer to a string buffer where the formatted string should be written to.
@@ -275,7 +325,28 @@ char *GetStringWithArgs(char *buffr, StringID string, StringParameters *args, co
 		error("String 0x%X is invalid. You are probably using an old version of the .lng file.\n", string);
 	}
 
-	return FormatString(buffr, GetStringPtr(string), args, last, case_index);
+	uint pos = _langpack.langtab_start[tab] + index;
+	const char *str = _langpack.offsets[pos];
+	switch (GetStringFormatPlan(pos)) {
+		case SFP_LITERAL: {
+			size_t len = strlen(str);
+			if (buffr + len >= last) break;
+			memcpy(buffr, str, len + 1);
+			return buffr + len;
+		}
+
+		case SFP_SINGLE_PASS:
+			/* NewGRF strings included by this string may need the dry run to fill its parameters. */
+			if (UsingNewGRFTextStack()) break;
+			/* None of the codes of the string behave differently in the dry run,
+			 * so it is formatted in one pass as a dry run. */
+			return FormatString(buffr, str, args, last, case_index, false, true);
+
+		default:
+			break;
+	}
+
+	return FormatString(buffr, str, args, last, case_index);
 }
 
 char *GetString(char *buffr, StringID string, const char *last)
@@ -1806,6 +1877,7 @@ bool ReadLanguagePack(const LanguageMetadata *lang)
 
 	_langpack.langpack = std::move(lang_pack);
 	_langpack.offsets = std::move(offs);
+	_langpack.plans.assign(_langpack.offsets.size(), SFP_UNKNOWN);
 	_langpack.langtab_num = tab_num;
 	_langpack.langtab_start = tab_start;
 
@@ -2024,6 +2096,176 @@ const char *GetCurrentLanguageIsoCode()
 	return _langpack.langpack->isocode;
 }
 
+/**
+ * Make up parameters for a string of the language pack, such that each code
+ * of the string gets a value it can format.
+ * @param str The string.
+ * @param params The parameters to fill in; they must be zero.
+ * @param num_params The number of parameters.
+ * @return False iff the string has codes for which no parameters can be made up.
+ */
+static bool MakeUpStringParameters(const char *str, uint64 *params, uint num_params)
+{
+	uint pos = 0;
+	for (;;) {
+		WChar c = Utf8Consume(&str);
+		if (c == '\0') return true;
+		if (c < SCC_CONTROL_START || c > SCC_CONTROL_END) continue;
+		if (c >= SCC_FIRST_FONT && c <= SCC_LAST_FONT) continue;
+		if (c >= SCC_BLUE && c <= SCC_POP_COLOUR) continue;
+
+		/* The values of the parameters read by the code. */
+		uint64 values[8] = { 1234, 1234 };
+		uint count = 1;
+		switch (c) {
+			case SCC_PLURAL_LIST:
+			case SCC_GENDER_LIST: {
+				/* Skip the plural form and parameter offset, or the parameter offset, and the choices. */
+				str += (c == SCC_PLURAL_LIST) ? 2 : 1;
+				uint n = (byte)*str++;
+				uint len = 0;
+				for (uint i = 0; i < n; i++) len += (byte)*str++;
+				str += len;
+				continue;
+			}
+
+			case SCC_GENDER_INDEX:
+			case SCC_SET_CASE:
+				str++;
+				continue;
+
+			case SCC_ARG_INDEX:
+				pos = (byte)*str++;
+				continue;
+
+			case SCC_SWITCH_CASE: {
+				/* Skip the cases, and continue with the default. */
+				uint n = (byte)*str++;
+				for (uint i = 0; i < n; i++) str += 3 + ((byte)str[1] << 8) + (byte)str[2];
+				continue;
+			}
+
+			case SCC_REVISION:
+				continue;
+
+			case SCC_STRING:
+				values[0] = STR_EMPTY;
+				break;
+
+			case SCC_STRING1:
+			case SCC_STRING2:
+			case SCC_STRING3:
+			case SCC_STRING4:
+			case SCC_STRING5:
+			case SCC_STRING6:
+			case SCC_STRING7:
+				values[0] = STR_EMPTY;
+				count = 1 + c - SCC_STRING1 + 1;
+				break;
+
+			case SCC_RAW_STRING_POINTER:
+				values[0] = (uint64)(size_t)"";
+				break;
+
+			case SCC_DECIMAL:
+				values[1] = 2;
+				count = 2;
+				break;
+
+			case SCC_ZEROFILL_NUM:
+				values[1] = 6;
+				count = 2;
+				break;
+
+			case SCC_CARGO_LONG:
+			case SCC_CARGO_SHORT:
+			case SCC_CARGO_TINY:
+				values[0] = 0;
+				count = 2;
+				break;
+
+			case SCC_CARGO_LIST:
+				values[0] = 1;
+				break;
+
+			case SCC_DEPOT_NAME:
+				values[0] = VEH_AIRCRAFT;
+				values[1] = 0;
+				count = 2;
+				break;
+
+			case SCC_COMPANY_NUM:
+			case SCC_STATION_FEATURES:
+			case SCC_INDUSTRY_NAME:
+			case SCC_WAYPOINT_NAME:
+			case SCC_STATION_NAME:
+			case SCC_TOWN_NAME:
+			case SCC_GROUP_NAME:
+			case SCC_VEHICLE_NAME:
+			case SCC_SIGN_NAME:
+			case SCC_COMPANY_NAME:
+			case SCC_PRESIDENT_NAME:
+			case SCC_ENGINE_NAME:
+				values[0] = 0;
+				break;
+
+			default:
+				if (c >= SCC_CURRENCY_SHORT && c <= SCC_DATE_ISO) break;
+				if (c >= SCC_COMMA && c <= SCC_BYTES) break;
+				/* NewGRF and encoded strings can not be part of the language pack. */
+				return false;
+		}
+
+		if (pos + count > num_params) return false;
+		for (uint i = 0; i < count; i++) params[pos++] = values[i];
+	}
+}
+
+/**
+ * Format all strings of the language pack a number of times, with made up
+ * parameters, to measure the speed of formatting strings.
+ * @param rounds Number of times to format each string.
+ * @return The number of strings that were formatted in each round.
+ */
+uint BenchmarkStringFormatting(uint rounds)
+{
+	static const uint NUM_PARAMS = 20;
+	struct BenchmarkString {
+		StringID string;
+		uint64 params[NUM_PARAMS];
+	};
+
+	std::vector<BenchmarkString> strings;
+	for (uint tab = 0; tab < TEXT_TAB_END; tab++) {
+		for (uint index = 0; index < _langpack.langtab_num[tab]; index++) {
+			/* These are not strings of the language pack, see GetStringWithArgs. */
+			if (tab == TEXT_TAB_TOWN && index >= 0xC0) continue;
+			if (tab == TEXT_TAB_SPECIAL && index >= 0xE4) continue;
+
+			BenchmarkString bs = {};
+			bs.string = MakeStringID((StringTab)tab, index);
+			if (bs.string == 0) continue;
+			if (!MakeUpStringParameters(_langpack.offsets[_langpack.langtab_start[tab] + index], bs.params, NUM_PARAMS)) continue;
+			strings.push_back(bs);
+		}
+	}
+
+	char buffer[DRAW_STRING_BUFFER];
+	uint64 data[NUM_PARAMS];
+	WChar type[NUM_PARAMS];
+	for (uint i = 0; i < rounds; i++) {
+		for (const BenchmarkString &bs : strings) {
+			/* Like GetString, but with the parameters of the string. */
+			memcpy(data, bs.params, sizeof(data));
+			StringParameters params(data, NUM_PARAMS, type);
+			params.ClearTypeInformation();
+			GetStringWithArgs(buffer, bs.string, &params, lastof(buffer));
+		}
+	}
+
+	return (uint)strings.size();
+}
+
 /**
  * Check whether there are glyphs missing in the current language.
  * @return If glyphs are missing, return \c true, else return \c false.
@@ -237,6 +237,7 @@ extern TextDirection _current_text_dir; ///< Text direction of the currently sel
 
 void InitializeLanguagePacks();
 const char *GetCurrentLanguageIsoCode();
+uint BenchmarkStringFormatting(uint rounds);
 
 bool StringIDSorter(const StringID &a, const StringID &b);
 
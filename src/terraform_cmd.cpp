@@ -16,6 +16,8 @@
 #include "object_base.h"
 #include "company_base.h"
 #include "company_func.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/yapf/yapf_cache.h"
 
 #include "table/strings.h"
 
@@ -307,8 +309,10 @@ CommandCost CmdTerraformLand(TileIndex tile, DoCommandFlag flags, uint32 p1, uin
 	}
 
 	if (flags & DC_EXEC) {
-		/* Mark affected areas dirty. */
+		/* Mark affected areas dirty. The slopes change, and with them the routes ships can take. */
 		for (TileIndexSet::const_iterator it = ts.dirty_tiles.begin(); it != ts.dirty_tiles.end(); it++) {
+			InvalidateWaterRegion(*it);
+			YapfNotifyRoadCostChange(*it);
 			MarkTileDirtyByTile(*it);
 			TileIndexToHeightMap::const_iterator new_height = ts.tile_to_new_height.find(tile);
 			if (new_height == ts.tile_to_new_height.end()) continue;
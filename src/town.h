@@ -16,6 +16,7 @@
 #include "newgrf_storage.h"
 #include "cargotype.h"
 #include <list>
+#include <map>
 
 template <typename T>
 struct BuildingCounts {
@@ -80,7 +81,10 @@ struct Town : TownPool::PoolItem<&_town_pool> {
 
 	inline byte GetPercentTransported(CargoID cid) const { return this->supplied[cid].old_act * 256 / (this->supplied[cid].old_max + 1); }
 
+	const StationList &GetStationsNearTile(TileIndex tile);
+
 	StationList stations_near;       ///< NOSAVE: List of nearby stations.
+	std::map<TileIndex, StationList> stations_near_tile; ///< NOSAVE: Cache of stations_near filtered per tile, @see Town::GetStationsNearTile()
 
 	uint16 time_until_rebuild;       ///< time until we rebuild a house
 
@@ -395,16 +395,19 @@ static bool IsCloseToTown(TileIndex tile, uint dist)
 void Town::UpdateVirtCoord()
 {
 	Point pt = RemapCoords2(TileX(this->xy) * TILE_SIZE, TileY(this->xy) * TILE_SIZE);
+	pt.y -= 24 * ZOOM_LVL_BASE;
 
-	if (this->cache.sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeTown(this->index));
+	/* Most updates are population changes, which do not move the sign. */
+	bool moved = !this->cache.sign.IsInKdtreeAt(pt.x, pt.y);
+	if (moved && this->cache.sign.kdtree_valid) _viewport_sign_kdtree.Remove(ViewportSignKdtreeItem::MakeTown(this->index));
 
 	SetDParam(0, this->index);
 	SetDParam(1, this->cache.population);
-	this->cache.sign.UpdatePosition(pt.x, pt.y - 24 * ZOOM_LVL_BASE,
+	this->cache.sign.UpdatePosition(pt.x, pt.y,
 		_settings_client.gui.population_in_label ? STR_VIEWPORT_TOWN_POP : STR_VIEWPORT_TOWN,
 		STR_VIEWPORT_TOWN);
 
-	_viewport_sign_kdtree.Insert(ViewportSignKdtreeItem::MakeTown(this->index));
+	if (moved) _viewport_sign_kdtree.Insert(ViewportSignKdtreeItem::MakeTown(this->index));
 
 	SetWindowDirty(WC_TOWN_VIEW, this->index);
 }
@@ -450,6 +453,24 @@ uint32 GetWorldPopulation()
 	return pop;
 }
 
+/**
+ * Get the nearby stations of this town whose catchment covers the given tile.
+ * The result is cached until the nearby stations of this town change.
+ * @param tile The tile to get the stations for.
+ * @return The stations covering the tile.
+ */
+const StationList &Town::GetStationsNearTile(TileIndex tile)
+{
+	auto found = this->stations_near_tile.find(tile);
+	if (found != this->stations_near_tile.end()) return found->second;
+
+	StationList &stations = this->stations_near_tile[tile];
+	for (Station *st : this->stations_near) {
+		if (st->TileIsInCatchment(tile)) stations.insert(st);
+	}
+	return stations;
+}
+
 /**
  * Remove stations from nearby station list if a town is no longer in the catchment area of each.
  * To improve performance only checks stations that cover the provided house area (doesn't need to contain an actual house).
@@ -469,6 +490,7 @@ static void RemoveNearbyStations(Town *t, TileIndex tile, BuildingFlags flags)
 
 		if (covers_area && !st->CatchmentCoversTown(t->index)) {
 			it = t->stations_near.erase(it);
+			t->stations_near_tile.clear();
 		} else {
 			++it;
 		}
@@ -2312,7 +2334,7 @@ static void MakeTownHouse(TileIndex t, Town *town, byte counter, byte stage, Hou
 
 	if (!_generating_world) {
 		ForAllStationsAroundTiles(TileArea(t, (size & BUILDING_2_TILES_X) ? 2 : 1, (size & BUILDING_2_TILES_Y) ? 2 : 1), [town](Station *st, TileIndex tile) {
-			town->stations_near.insert(st);
+			if (town->stations_near.insert(st).second) town->stations_near_tile.clear();
 			return true;
 		});
 	}
@@ -2342,18 +2364,59 @@ static inline bool CanBuildHouseHere(TileIndex tile, bool noslope)
 	return DoCommand(tile, 0, 0, DC_AUTO | DC_NO_WATER, CMD_LANDSCAPE_CLEAR).Succeeded();
 }
 
+/**
+ * Cache of CanBuildHouseHere() for the tiles around the tile a town tries to build a house at.
+ * Every candidate house is tested on (a part of) the same tiles, and nothing changes the map
+ * until one of them is built, so the expensive land clearing test is needed at most once per tile.
+ */
+struct HouseTileCache {
+	TileIndex base_tile; ///< The tile the town tries to build a house at.
+	int8 buildable[3][3]; ///< Whether a house can be built (1) or not (0) on the tiles around #base_tile, or -1 when not known yet.
+
+	/**
+	 * Create the cache for building a house around a tile.
+	 * @param base_tile The tile the town tries to build a house at.
+	 */
+	HouseTileCache(TileIndex base_tile) : base_tile(base_tile)
+	{
+		memset(this->buildable, -1, sizeof(this->buildable));
+	}
+
+	/**
+	 * Checks if a house can be built here, using the cached result when there is one.
+	 * @param tile tile to check
+	 * @param noslope are slopes (foundations) allowed?
+	 * @return true iff house can be built here
+	 * @see ::CanBuildHouseHere()
+	 */
+	bool CanBuildHouseHere(TileIndex tile, bool noslope)
+	{
+		int dx = (int)TileX(tile) - (int)TileX(this->base_tile) + 1;
+		int dy = (int)TileY(tile) - (int)TileY(this->base_tile) + 1;
+		if (dx < 0 || dx > 2 || dy < 0 || dy > 2) return ::CanBuildHouseHere(tile, noslope);
+
+		/* The only part depending on noslope is cheap, so cache the result without it. */
+		if (noslope && GetTileSlope(tile) != SLOPE_FLAT) return false;
+
+		int8 &buildable = this->buildable[dx][dy];
+		if (buildable < 0) buildable = ::CanBuildHouseHere(tile, false) ? 1 : 0;
+		return buildable != 0;
+	}
+};
+
 
 /**
  * Checks if a house can be built at this tile, must have the same max z as parameter.
  * @param tile tile to check
  * @param z max z of this tile so more parts of a house are at the same height (with foundation)
  * @param noslope are slopes (foundations) allowed?
+ * @param cache cache of the buildable tiles
  * @return true iff house can be built here
  * @see CanBuildHouseHere()
  */
-static inline bool CheckBuildHouseSameZ(TileIndex tile, int z, bool noslope)
+static inline bool CheckBuildHouseSameZ(TileIndex tile, int z, bool noslope, HouseTileCache &cache)
 {
-	if (!CanBuildHouseHere(tile, noslope)) return false;
+	if (!cache.CanBuildHouseHere(tile, noslope)) return false;
 
 	/* if building on slopes is allowed, there will be flattening foundation (to tile max z) */
 	if (GetTileMaxZ(tile) != z) return false;
@@ -2367,17 +2430,18 @@ static inline bool CheckBuildHouseSameZ(TileIndex tile, int z, bool noslope)
  * @param tile tile, N corner
  * @param z maximum tile z so all tile have the same max z
  * @param noslope are slopes (foundations) allowed?
+ * @param cache cache of the buildable tiles
  * @return true iff house can be built
  * @see CheckBuildHouseSameZ()
  */
-static bool CheckFree2x2Area(TileIndex tile, int z, bool noslope)
+static bool CheckFree2x2Area(TileIndex tile, int z, bool noslope, HouseTileCache &cache)
 {
 	/* we need to check this tile too because we can be at different tile now */
-	if (!CheckBuildHouseSameZ(tile, z, noslope)) return false;
+	if (!CheckBuildHouseSameZ(tile, z, noslope, cache)) return false;
 
 	for (DiagDirection d = DIAGDIR_SE; d < DIAGDIR_END; d++) {
 		tile += TileOffsByDiagDir(d);
-		if (!CheckBuildHouseSameZ(tile, z, noslope)) return false;
+		if (!CheckBuildHouseSameZ(tile, z, noslope, cache)) return false;
 	}
 
 	return true;
@@ -2458,16 +2522,17 @@ static inline bool TownLayoutAllows2x2HouseHere(Town *t, TileIndex tile)
  * @param maxz all tiles should have the same height
  * @param noslope are slopes forbidden?
  * @param second diagdir from first tile to second tile
+ * @param cache cache of the buildable tiles
  */
-static bool CheckTownBuild2House(TileIndex *tile, Town *t, int maxz, bool noslope, DiagDirection second)
+static bool CheckTownBuild2House(TileIndex *tile, Town *t, int maxz, bool noslope, DiagDirection second, HouseTileCache &cache)
 {
 	/* 'tile' is already checked in BuildTownHouse() - CanBuildHouseHere() and slope test */
 
 	TileIndex tile2 = *tile + TileOffsByDiagDir(second);
-	if (TownLayoutAllowsHouseHere(t, tile2) && CheckBuildHouseSameZ(tile2, maxz, noslope)) return true;
+	if (TownLayoutAllowsHouseHere(t, tile2) && CheckBuildHouseSameZ(tile2, maxz, noslope, cache)) return true;
 
 	tile2 = *tile + TileOffsByDiagDir(ReverseDiagDir(second));
-	if (TownLayoutAllowsHouseHere(t, tile2) && CheckBuildHouseSameZ(tile2, maxz, noslope)) {
+	if (TownLayoutAllowsHouseHere(t, tile2) && CheckBuildHouseSameZ(tile2, maxz, noslope, cache)) {
 		*tile = tile2;
 		return true;
 	}
@@ -2483,13 +2548,14 @@ static bool CheckTownBuild2House(TileIndex *tile, Town *t, int maxz, bool noslop
  * @param t town
  * @param maxz all tiles should have the same height
  * @param noslope are slopes forbidden?
+ * @param cache cache of the buildable tiles
  */
-static bool CheckTownBuild2x2House(TileIndex *tile, Town *t, int maxz, bool noslope)
+static bool CheckTownBuild2x2House(TileIndex *tile, Town *t, int maxz, bool noslope, HouseTileCache &cache)
 {
 	TileIndex tile2 = *tile;
 
 	for (DiagDirection d = DIAGDIR_SE;; d++) { // 'd' goes through DIAGDIR_SE, DIAGDIR_SW, DIAGDIR_NW, DIAGDIR_END
-		if (TownLayoutAllows2x2HouseHere(t, tile2) && CheckFree2x2Area(tile2, maxz, noslope)) {
+		if (TownLayoutAllows2x2HouseHere(t, tile2) && CheckFree2x2Area(tile2, maxz, noslope, cache)) {
 			*tile = tile2;
 			return true;
 		}
@@ -2513,7 +2579,8 @@ static bool BuildTownHouse(Town *t, TileIndex tile)
 	if (!TownLayoutAllowsHouseHere(t, tile)) return false;
 
 	/* no house allowed at all, bail out */
-	if (!CanBuildHouseHere(tile, false)) return false;
+	HouseTileCache cache(tile);
+	if (!cache.CanBuildHouseHere(tile, false)) return false;
 
 	Slope slope = GetTileSlope(tile);
 	int maxz = GetTileMaxZ(tile);
@@ -2607,11 +2674,11 @@ static bool BuildTownHouse(Town *t, TileIndex tile)
 		if (noslope && slope != SLOPE_FLAT) continue;
 
 		if (hs->building_flags & TILE_SIZE_2x2) {
-			if (!CheckTownBuild2x2House(&tile, t, maxz, noslope)) continue;
+			if (!CheckTownBuild2x2House(&tile, t, maxz, noslope, cache)) continue;
 		} else if (hs->building_flags & TILE_SIZE_2x1) {
-			if (!CheckTownBuild2House(&tile, t, maxz, noslope, DIAGDIR_SW)) continue;
+			if (!CheckTownBuild2House(&tile, t, maxz, noslope, DIAGDIR_SW, cache)) continue;
 		} else if (hs->building_flags & TILE_SIZE_1x2) {
-			if (!CheckTownBuild2House(&tile, t, maxz, noslope, DIAGDIR_SE)) continue;
+			if (!CheckTownBuild2House(&tile, t, maxz, noslope, DIAGDIR_SE, cache)) continue;
 		} else {
 			/* 1x1 house checks are already done */
 		}
@@ -3257,6 +3324,7 @@ static CommandCost TownActionBribe(Town *t, DoCommandFlag flags)
 			for (Station *st : Station::Iterate()) {
 				if (st->town == t && st->owner == _current_company) {
 					for (CargoID i = 0; i < NUM_CARGO; i++) st->goods[i].rating = 0;
+					st->rated_cargoes = ALL_CARGOTYPES;
 				}
 			}
 
@@ -1337,7 +1337,7 @@ static inline void ChangeVehicleWindow(WindowClass window_class, VehicleID from_
 	Window *w = FindWindowById(window_class, from_index);
 	if (w != nullptr) {
 		/* Update window_number */
-		w->window_number = to_index;
+		w->SetWindowNumber(to_index);
 		if (w->viewport != nullptr) w->viewport->follow_vehicle = to_index;
 
 		/* Update vehicle drag data */
@@ -1926,7 +1926,7 @@ public:
 		if (!gui_scope && HasBit(data, 31) && this->vli.type == VL_SHARED_ORDERS) {
 			/* Needs to be done in command-scope, so everything stays valid */
 			this->vli.index = GB(data, 0, 20);
-			this->window_number = this->vli.Pack();
+			this->SetWindowNumber(this->vli.Pack());
 			this->vehgroups.ForceRebuild();
 			return;
 		}
@@ -105,6 +105,30 @@ void BuildDepotVehicleList(VehicleType type, TileIndex tile, VehicleList *engine
 	if (wagons != nullptr && wagons != engines) wagons->shrink_to_fit();
 }
 
+/**
+ * Add the vehicles sharing an order list to a vehicle list.
+ * @param list The list to add the vehicles to.
+ * @param orders The order list.
+ * @param type The type of vehicles the list is for.
+ */
+static void AddOrderListVehicles(VehicleList *list, const OrderList *orders, VehicleType type)
+{
+	for (const Vehicle *v = orders->GetFirstSharedVehicle(); v != nullptr; v = v->NextShared()) {
+		if (v->type == type && v->IsPrimaryVehicle()) list->push_back(v);
+	}
+}
+
+/**
+ * Sort vehicles by their index, so lists built from order lists are in the same order as the vehicle pool.
+ * @param a First vehicle.
+ * @param b Second vehicle.
+ * @return True iff \a a comes before \a b.
+ */
+static bool VehicleIndexSorter(const Vehicle * const &a, const Vehicle * const &b)
+{
+	return a->index < b->index;
+}
+
 /**
  * Generate a list of vehicles based on window type.
  * @param list Pointer to list to add vehicles to
@@ -117,17 +141,11 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 
 	switch (vli.type) {
 		case VL_STATION_LIST:
-			for (const Vehicle *v : Vehicle::Iterate()) {
-				if (v->type == vli.vtype && v->IsPrimaryVehicle()) {
-					for (const Order *order : v->Orders()) {
-						if ((order->IsType(OT_GOTO_STATION) || order->IsType(OT_GOTO_WAYPOINT) || order->IsType(OT_IMPLICIT))
-								&& order->GetDestination() == vli.index) {
-							list->push_back(v);
-							break;
-						}
-					}
-				}
+			/* All station orders are of interest, so every order list found will do. */
+			for (const OrderList *orders : OrderList::GetByDestination(OT_GOTO_STATION, vli.index)) {
+				AddOrderListVehicles(list, orders, vli.vtype);
 			}
+			std::sort(list->begin(), list->end(), VehicleIndexSorter);
 			break;
 
 		case VL_SHARED_ORDERS: {
@@ -162,16 +180,15 @@ bool GenerateVehicleSortList(VehicleList *list, const VehicleListIdentifier &vli
 			break;
 
 		case VL_DEPOT_LIST:
-			for (const Vehicle *v : Vehicle::Iterate()) {
-				if (v->type == vli.vtype && v->IsPrimaryVehicle()) {
-					for (const Order *order : v->Orders()) {
-						if (order->IsType(OT_GOTO_DEPOT) && !(order->GetDepotActionType() & ODATFB_NEAREST_DEPOT) && order->GetDestination() == vli.index) {
-							list->push_back(v);
-							break;
-						}
+			for (const OrderList *orders : OrderList::GetByDestination(OT_GOTO_DEPOT, vli.index)) {
+				for (const Order *order = orders->GetFirstOrder(); order != nullptr; order = order->next) {
+					if (order->IsType(OT_GOTO_DEPOT) && !(order->GetDepotActionType() & ODATFB_NEAREST_DEPOT) && order->GetDestination() == vli.index) {
+						AddOrderListVehicles(list, orders, vli.vtype);
+						break;
 					}
 				}
 			}
+			std::sort(list->begin(), list->end(), VehicleIndexSorter);
 			break;
 
 		default: return false;
@@ -79,6 +79,7 @@
 #include "window_func.h"
 #include "tilehighlight_func.h"
 #include "window_gui.h"
+#include "smallmap_gui.h"
 #include "linkgraph/linkgraph_gui.h"
 #include "viewport_kdtree.h"
 #include "town_kdtree.h"
@@ -89,7 +90,6 @@
 #include "network/network_func.h"
 #include "framerate_type.h"
 
-#include <forward_list>
 #include <map>
 #include <stack>
 
@@ -1353,10 +1353,14 @@ static void ViewportAddKdtreeSigns(DrawPixelInfo *dpi)
 	const BaseStation *st;
 	const Sign *si;
 
-	/* Collect all the items first and draw afterwards, to ensure layering */
-	std::vector<const BaseStation *> stations;
-	std::vector<const Town *> towns;
-	std::vector<const Sign *> signs;
+	/* Collect all the items first and draw afterwards, to ensure layering.
+	 * The lists keep their memory between redraws. */
+	static std::vector<const BaseStation *> stations;
+	static std::vector<const Town *> towns;
+	static std::vector<const Sign *> signs;
+	stations.clear();
+	towns.clear();
+	signs.clear();
 
 	_viewport_sign_kdtree.FindContained(search_rect.left, search_rect.top, search_rect.right, search_rect.bottom, [&](const ViewportSignKdtreeItem & item) {
 		switch (item.type) {
@@ -1462,6 +1466,23 @@ void ViewportSign::UpdatePosition(int center, int top, StringID str, StringID st
 	this->MarkDirty();
 }
 
+/**
+ * Update the position of the viewport sign.
+ * Note that this function hides the base class function.
+ * @param center the (preferred) center of the viewport sign
+ * @param top    the new top of the sign
+ * @param str    the string to show in the sign
+ * @param str_small the string to show when zoomed out. STR_NULL means same as \a str
+ */
+void TrackedViewportSign::UpdatePosition(int center, int top, StringID str, StringID str_small)
+{
+	this->kdtree_valid = true;
+	this->ViewportSign::UpdatePosition(center, top, str, str_small);
+
+	/* Signs that stay in the kd-tree may still grow. */
+	_viewport_sign_maxwidth = std::max<int>(_viewport_sign_maxwidth, this->width_normal);
+}
+
 /**
  * Mark the sign dirty in all viewports.
  * @param maxzoom Maximum %ZoomLevel at which the text is visible.
@@ -1517,22 +1538,20 @@ static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 	 */
 	const uint32 ORDER_COMPARED = UINT32_MAX; // Sprite was compared but we still need to compare the ones preceding it
 	const uint32 ORDER_RETURNED = UINT32_MAX - 1; // Makr sorted sprite in case there are other occurrences of it in the stack
-	std::stack<ParentSpriteToDraw *> sprite_order;
+	static ParentSpriteSortStack sprite_order;
 	uint32 next_order = 0;
 
-	std::forward_list<std::pair<int64, ParentSpriteToDraw *>> sprite_list;  // We store sprites in a list sorted by xmin+ymin
+	static ParentSpriteSortList sprite_list;  // We store sprites in a list sorted by xmin+ymin
 
 	/* Initialize sprite list and order. */
+	sprite_list.Assign(psdv);
 	for (auto p = psdv->rbegin(); p != psdv->rend(); p++) {
-		sprite_list.push_front(std::make_pair((*p)->xmin + (*p)->ymin, *p));
 		sprite_order.push(*p);
 		(*p)->order = next_order++;
 	}
 
-	sprite_list.sort();
-
-	std::vector<ParentSpriteToDraw *> preceding;  // Temporarily stores sprites that precede current and their position in the list
-	auto preceding_prev = sprite_list.begin(); // Store iterator in case we need to delete a single preciding sprite
+	static std::vector<ParentSpriteToDraw *> preceding;  // Temporarily stores sprites that precede current and their position in the list
+	ParentSpriteSortList::Position preceding_prev = sprite_list.BeforeBegin(); // Store position in case we need to delete a single preciding sprite
 	auto out = psdv->begin();  // Iterator to output sorted sprites
 
 	while (!sprite_order.empty()) {
@@ -1561,18 +1580,19 @@ static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 		 * to ensure that we iterate the current sprite as we need to remove it from the list.
 		 */
 		auto ssum = std::max(s->xmax, s->xmin) + std::max(s->ymax, s->ymin);
-		auto prev = sprite_list.before_begin();
-		auto x = sprite_list.begin();
-		while (x != sprite_list.end() && ((*x).first <= ssum)) {
-			auto p = (*x).second;
+		ParentSpriteSortList::Position prev = sprite_list.BeforeBegin();
+		ParentSpriteSortList::Position x = sprite_list.Next(prev);
+		while (x != ParentSpriteSortList::END && sprite_list.Key(x) <= ssum) {
+			auto p = sprite_list.Sprite(x);
 			if (p == s) {
 				/* We found the current sprite, remove it and move on. */
-				x = sprite_list.erase_after(prev);
+				x = sprite_list.EraseAfter(prev);
 				continue;
 			}
 
 			auto p_prev = prev;
-			prev = x++;
+			prev = x;
+			x = sprite_list.Next(x);
 
 			if (s->xmax < p->xmin || s->ymax < p->ymin || s->zmax < p->zmin) continue;
 			if (s->xmin <= p->xmax && // overlap in X?
@@ -1601,7 +1621,7 @@ static void ViewportSortParentSprites(ParentSpriteToSortVector *psdv)
 			if (p->xmax <= s->xmax && p->ymax <= s->ymax && p->zmax <= s->zmax) {
 				p->order = ORDER_RETURNED;
 				s->order = ORDER_RETURNED;
-				sprite_list.erase_after(preceding_prev);
+				sprite_list.EraseAfter(preceding_prev);
 				*(out++) = p;
 				*(out++) = s;
 				continue;
@@ -1986,6 +2006,8 @@ void ConstrainAllViewportsZoom()
  */
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override)
 {
+	InvalidateSmallMapColourCache(tile);
+
 	Point pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tile_height_override * TILE_HEIGHT);
 	MarkAllViewportsDirty(
 			pt.x - MAX_TILE_EXTENT_LEFT,
@@ -10,6 +10,8 @@
 #include "stdafx.h"
 #include "core/smallvec_type.hpp"
 #include "gfx_type.h"
+#include <algorithm>
+#include <stack>
 
 #ifndef VIEWPORT_SPRITE_SORTER_H
 #define VIEWPORT_SPRITE_SORTER_H
@@ -41,6 +43,67 @@ struct ParentSpriteToDraw {
 
 typedef std::vector<ParentSpriteToDraw*> ParentSpriteToSortVector;
 
+/**
+ * Singly linked list of parent sprites sorted by xmin + ymin, for use by the sprite sorters.
+ * All nodes are stored in one array which is kept between sorts, so sorting does not
+ * allocate every node separately each time the viewport is drawn.
+ */
+class ParentSpriteSortList {
+public:
+	typedef uint32 Position;                 ///< Position of a node in the list.
+	static const Position END = UINT32_MAX;  ///< Position past the end of the list.
+
+	/**
+	 * Fill the list with the given sprites, sorted by xmin + ymin.
+	 * Sprites with the same xmin + ymin keep their order in \a psdv.
+	 * @param psdv The sprites to sort.
+	 */
+	void Assign(const ParentSpriteToSortVector *psdv)
+	{
+		this->nodes.clear();
+		this->nodes.push_back({0, nullptr, END}); // Node before the first sprite.
+		for (ParentSpriteToDraw *p : *psdv) {
+			this->nodes.push_back({(int64)p->xmin + p->ymin, p, END});
+		}
+		std::stable_sort(this->nodes.begin() + 1, this->nodes.end(), [](const Node &a, const Node &b) {
+			return a.key < b.key;
+		});
+		for (Position i = 0; i + 1 < this->nodes.size(); i++) this->nodes[i].next = i + 1;
+	}
+
+	/** Get the position before the first sprite, so the first sprite can be erased. */
+	inline Position BeforeBegin() const { return 0; }
+	/** Get the position following \a pos. */
+	inline Position Next(Position pos) const { return this->nodes[pos].next; }
+	/** Get xmin + ymin of the sprite at \a pos. */
+	inline int64 Key(Position pos) const { return this->nodes[pos].key; }
+	/** Get the sprite at \a pos. */
+	inline ParentSpriteToDraw *Sprite(Position pos) const { return this->nodes[pos].sprite; }
+
+	/**
+	 * Erase the sprite following \a pos from the list.
+	 * @param pos Position before the sprite to erase.
+	 * @return Position of the sprite following the erased sprite.
+	 */
+	inline Position EraseAfter(Position pos)
+	{
+		this->nodes[pos].next = this->nodes[this->nodes[pos].next].next;
+		return this->nodes[pos].next;
+	}
+
+private:
+	/** A sprite in the list. */
+	struct Node {
+		int64 key;                  ///< xmin + ymin of the sprite.
+		ParentSpriteToDraw *sprite; ///< The sprite.
+		Position next;              ///< Position of the next sprite.
+	};
+	std::vector<Node> nodes;        ///< The nodes; the first node is the one before the first sprite.
+};
+
+/** Stack of sprites used by the sprite sorters, backed by a vector so it keeps its memory between sorts. */
+typedef std::stack<ParentSpriteToDraw *, std::vector<ParentSpriteToDraw *>> ParentSpriteSortStack;
+
 /** Type for method for checking whether a viewport sprite sorter exists. */
 typedef bool (*VpSorterChecker)();
 /** Type for the actual viewport sprite sorter. */
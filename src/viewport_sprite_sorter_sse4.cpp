@@ -13,7 +13,6 @@
 #include "cpu.h"
 #include "smmintrin.h"
 #include "viewport_sprite_sorter.h"
-#include <forward_list>
 #include <map>
 #include <stack>
 
@@ -41,22 +40,20 @@ void ViewportSortParentSpritesSSE41(ParentSpriteToSortVector *psdv)
 	 */
 	const uint32 ORDER_COMPARED = UINT32_MAX; // Sprite was compared but we still need to compare the ones preceding it
 	const uint32 ORDER_RETURNED = UINT32_MAX - 1; // Mark sorted sprite in case there are other occurrences of it in the stack
-	std::stack<ParentSpriteToDraw *> sprite_order;
+	static ParentSpriteSortStack sprite_order;
 	uint32 next_order = 0;
 
-	std::forward_list<std::pair<int64, ParentSpriteToDraw *>> sprite_list;  // We store sprites in a list sorted by xmin+ymin
+	static ParentSpriteSortList sprite_list;  // We store sprites in a list sorted by xmin+ymin
 
 	/* Initialize sprite list and order. */
+	sprite_list.Assign(psdv);
 	for (auto p = psdv->rbegin(); p != psdv->rend(); p++) {
-		sprite_list.push_front(std::make_pair((*p)->xmin + (*p)->ymin, *p));
 		sprite_order.push(*p);
 		(*p)->order = next_order++;
 	}
 
-	sprite_list.sort();
-
-	std::vector<ParentSpriteToDraw *> preceding;  // Temporarily stores sprites that precede current and their position in the list
-	auto preceding_prev = sprite_list.begin(); // Store iterator in case we need to delete a single preciding sprite
+	static std::vector<ParentSpriteToDraw *> preceding;  // Temporarily stores sprites that precede current and their position in the list
+	ParentSpriteSortList::Position preceding_prev = sprite_list.BeforeBegin(); // Store position in case we need to delete a single preciding sprite
 	auto out = psdv->begin();  // Iterator to output sorted sprites
 
 	while (!sprite_order.empty()) {
@@ -85,18 +82,19 @@ void ViewportSortParentSpritesSSE41(ParentSpriteToSortVector *psdv)
 		 * to ensure that we iterate the current sprite as we need to remove it from the list.
 		 */
 		auto ssum = std::max(s->xmax, s->xmin) + std::max(s->ymax, s->ymin);
-		auto prev = sprite_list.before_begin();
-		auto x = sprite_list.begin();
-		while (x != sprite_list.end() && ((*x).first <= ssum)) {
-			auto p = (*x).second;
+		ParentSpriteSortList::Position prev = sprite_list.BeforeBegin();
+		ParentSpriteSortList::Position x = sprite_list.Next(prev);
+		while (x != ParentSpriteSortList::END && sprite_list.Key(x) <= ssum) {
+			auto p = sprite_list.Sprite(x);
 			if (p == s) {
 				/* We found the current sprite, remove it and move on. */
-				x = sprite_list.erase_after(prev);
+				x = sprite_list.EraseAfter(prev);
 				continue;
 			}
 
 			auto p_prev = prev;
-			prev = x++;
+			prev = x;
+			x = sprite_list.Next(x);
 
 			/* Check that p->xmin <= s->xmax && p->ymin <= s->ymax && p->zmin <= s->zmax */
 			__m128i s_max = LOAD_128((__m128i*) &s->xmax);
@@ -142,7 +140,7 @@ void ViewportSortParentSpritesSSE41(ParentSpriteToSortVector *psdv)
 			if (p->xmax <= s->xmax && p->ymax <= s->ymax && p->zmax <= s->zmax) {
 				p->order = ORDER_RETURNED;
 				s->order = ORDER_RETURNED;
-				sprite_list.erase_after(preceding_prev);
+				sprite_list.EraseAfter(preceding_prev);
 				*(out++) = p;
 				*(out++) = s;
 				continue;
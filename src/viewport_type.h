@@ -57,17 +57,21 @@ struct ViewportSign {
 struct TrackedViewportSign : ViewportSign {
 	bool kdtree_valid; ///< Are the sign data valid for use with the _viewport_sign_kdtree?
 
+	void UpdatePosition(int center, int top, StringID str, StringID str_small = STR_NULL);
+
 	/**
-	 * Update the position of the viewport sign.
-	 * Note that this function hides the base class function.
+	 * Check whether the sign is in the _viewport_sign_kdtree at the given position.
+	 * The kd-tree only knows the position of the sign, so when this is the case
+	 * the sign does not need to be removed from and inserted in it again.
+	 * @param center The center of the sign.
+	 * @param top    The top of the sign.
+	 * @return True iff the sign is in the kd-tree at this position.
 	 */
-	void UpdatePosition(int center, int top, StringID str, StringID str_small = STR_NULL)
+	bool IsInKdtreeAt(int center, int top) const
 	{
-		this->kdtree_valid = true;
-		this->ViewportSign::UpdatePosition(center, top, str, str_small);
+		return this->kdtree_valid && this->center == center && this->top == top;
 	}
 
-
 	TrackedViewportSign() : kdtree_valid{ false }
 	{
 	}
@@ -38,6 +38,7 @@
 #include "company_gui.h"
 #include "newgrf_generic.h"
 #include "industry.h"
+#include "pathfinder/water_regions.h"
 
 #include "table/strings.h"
 
@@ -147,6 +148,8 @@ CommandCost CmdBuildShipDepot(TileIndex tile, DoCommandFlag flags, uint32 p1, ui
 
 		MakeShipDepot(tile,  _current_company, depot->index, DEPOT_PART_NORTH, axis, wc1);
 		MakeShipDepot(tile2, _current_company, depot->index, DEPOT_PART_SOUTH, axis, wc2);
+		InvalidateWaterRegion(tile);
+		InvalidateWaterRegion(tile2);
 		CheckForDockingTile(tile);
 		CheckForDockingTile(tile2);
 		MarkTileDirtyByTile(tile);
@@ -251,6 +254,7 @@ void MakeWaterKeepingClass(TileIndex tile, Owner o)
 		default: break;
 	}
 
+	InvalidateWaterRegion(tile);
 	if (wc != WATER_CLASS_INVALID) CheckForDockingTile(tile);
 	MarkTileDirtyByTile(tile);
 }
@@ -351,6 +355,9 @@ static CommandCost DoBuildLock(TileIndex tile, DiagDirection dir, DoCommandFlag
 		}
 
 		MakeLock(tile, _current_company, dir, wc_lower, wc_upper, wc_middle);
+		InvalidateWaterRegion(tile);
+		InvalidateWaterRegion(tile - delta);
+		InvalidateWaterRegion(tile + delta);
 		CheckForDockingTile(tile - delta);
 		CheckForDockingTile(tile + delta);
 		MarkTileDirtyByTile(tile);
@@ -395,6 +402,7 @@ static CommandCost RemoveLock(TileIndex tile, DoCommandFlag flags)
 
 		if (GetWaterClass(tile) == WATER_CLASS_RIVER) {
 			MakeRiver(tile, Random());
+			InvalidateWaterRegion(tile);
 		} else {
 			DoClearSquare(tile);
 		}
@@ -509,6 +517,7 @@ CommandCost CmdBuildCanal(TileIndex tile, DoCommandFlag flags, uint32 p1, uint32
 					}
 					break;
 			}
+			InvalidateWaterRegion(tile);
 			MarkTileDirtyByTile(tile);
 			MarkCanalsAndRiversAroundDirty(tile);
 			CheckForDockingTile(tile);
@@ -1157,6 +1166,8 @@ void DoFloodTile(TileIndex target)
 	}
 
 	if (flooded) {
+		InvalidateWaterRegion(target);
+
 		/* Mark surrounding canal tiles dirty too to avoid glitches */
 		MarkCanalsAndRiversAroundDirty(target);
 
@@ -1210,6 +1221,7 @@ static void DoDryUp(TileIndex tile)
 		default: NOT_REACHED();
 	}
 
+	InvalidateWaterRegion(tile);
 	cur_company.Restore();
 }
 
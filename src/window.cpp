@@ -9,6 +9,7 @@
 
 #include "stdafx.h"
 #include <stdarg.h>
+#include <unordered_map>
 #include "company_func.h"
 #include "gfx_func.h"
 #include "console_func.h"
@@ -56,6 +57,12 @@ static Window *_last_scroll_window = nullptr; ///< Window of the last scroll eve
 /** List of windows opened at the screen sorted from the front to back. */
 WindowList _z_windows;
 
+/** Initialised windows by their class and number, see #GetWindowIndexKey(). */
+static std::unordered_multimap<uint64, Window *> _window_index;
+
+/** Windows with #WF_DIRTY set, to be marked dirty before the next redraw. */
+static std::vector<Window *> _deferred_dirty_windows;
+
 /** If false, highlight is white, otherwise the by the widget defined colour. */
 bool _window_highlight_colour = false;
 
@@ -1108,9 +1115,79 @@ Window::~Window()
 	free(this->nested_array); // Contents is released through deletion of #nested_root.
 	delete this->nested_root;
 
+	if (this->flags & WF_DIRTY) {
+		_deferred_dirty_windows.erase(std::find(_deferred_dirty_windows.begin(), _deferred_dirty_windows.end(), this));
+	}
+	this->RemoveFromIndex();
+
 	*this->z_position = nullptr;
 }
 
+/**
+ * Get the key of windows in #_window_index.
+ * @param cls Window class
+ * @param number Number of the window within the window class
+ * @return The key.
+ */
+static inline uint64 GetWindowIndexKey(WindowClass cls, WindowNumber number)
+{
+	return (uint64)cls << 32 | (uint32)number;
+}
+
+/**
+ * Add the window to the index of windows by its current class and number.
+ */
+void Window::AddToIndex()
+{
+	this->RemoveFromIndex();
+
+	this->indexed = true;
+	this->indexed_class = this->window_class;
+	this->indexed_number = this->window_number;
+	_window_index.emplace(GetWindowIndexKey(this->window_class, this->window_number), this);
+}
+
+/**
+ * Remove the window from the index of windows, if it is in there.
+ */
+void Window::RemoveFromIndex()
+{
+	if (!this->indexed) return;
+
+	auto range = _window_index.equal_range(GetWindowIndexKey(this->indexed_class, this->indexed_number));
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == this) {
+			_window_index.erase(it);
+			break;
+		}
+	}
+	this->indexed = false;
+}
+
+/**
+ * Change the class of the window.
+ * Always use this instead of assigning #window_class once the window is initialised,
+ * so it can still be found by its class.
+ * @param window_class The new window class.
+ */
+void Window::SetWindowClass(WindowClass window_class)
+{
+	this->window_class = window_class;
+	if (this->indexed) this->AddToIndex();
+}
+
+/**
+ * Change the number of the window.
+ * Always use this instead of assigning #window_number once the window is initialised,
+ * so it can still be found by its number.
+ * @param window_number The new window number.
+ */
+void Window::SetWindowNumber(WindowNumber window_number)
+{
+	this->window_number = window_number;
+	if (this->indexed) this->AddToIndex();
+}
+
 /**
  * Find a window by its class and window number
  * @param cls Window class
@@ -1119,6 +1196,14 @@ Window::~Window()
  */
 Window *FindWindowById(WindowClass cls, WindowNumber number)
 {
+	auto range = _window_index.equal_range(GetWindowIndexKey(cls, number));
+	if (range.first == range.second) return nullptr;
+	if (std::next(range.first) == range.second) {
+		assert(range.first->second->window_class == cls && range.first->second->window_number == number);
+		return range.first->second;
+	}
+
+	/* There are several such windows; return the backmost one. */
 	for (Window *w : Window::Iterate()) {
 		if (w->window_class == cls && w->window_number == number) return w;
 	}
@@ -1376,6 +1461,7 @@ void Window::InitializeData(WindowNumber window_number)
 	this->owner = INVALID_OWNER;
 	this->nested_focus = nullptr;
 	this->window_number = window_number;
+	this->AddToIndex();
 
 	this->OnInit();
 	/* Initialize nested widget tree. */
@@ -3013,6 +3099,18 @@ void CallWindowRealtimeTickEvent(uint delta_ms)
 	}
 }
 
+/**
+ * Mark the windows dirty whose marking was deferred by #SetWindowDirty().
+ */
+static void SetDeferredWindowsDirty()
+{
+	for (Window *w : _deferred_dirty_windows) {
+		w->flags &= ~WF_DIRTY;
+		w->SetDirty();
+	}
+	_deferred_dirty_windows.clear();
+}
+
 /**
  * Update the continuously changing contents of the windows, such as the viewports
  */
@@ -3063,6 +3161,8 @@ void UpdateWindows()
 
 	if (!_pause_mode || _game_mode == GM_EDITOR || _settings_game.construction.command_pause_level > CMDPL_NO_CONSTRUCTION) MoveAllTextEffects(delta_ms);
 
+	SetDeferredWindowsDirty();
+
 	/* Skip the actual drawing on dedicated servers without screen.
 	 * But still empty the invalidation queues above. */
 	if (_network_dedicated) return;
@@ -3096,8 +3196,14 @@ void UpdateWindows()
  */
 void SetWindowDirty(WindowClass cls, WindowNumber number)
 {
-	for (const Window *w : Window::Iterate()) {
-		if (w->window_class == cls && w->window_number == number) w->SetDirty();
+	/* Marking the windows dirty is deferred until the next redraw, so marking
+	 * the same window many times during a tick only costs a flag test. */
+	auto range = _window_index.equal_range(GetWindowIndexKey(cls, number));
+	for (auto it = range.first; it != range.second; ++it) {
+		Window *w = it->second;
+		if (w->flags & WF_DIRTY) continue;
+		w->flags |= WF_DIRTY;
+		_deferred_dirty_windows.push_back(w);
 	}
 }
 
@@ -3109,10 +3215,12 @@ void SetWindowDirty(WindowClass cls, WindowNumber number)
  */
 void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, byte widget_index)
 {
-	for (const Window *w : Window::Iterate()) {
-		if (w->window_class == cls && w->window_number == number) {
-			w->SetWidgetDirty(widget_index);
-		}
+	auto range = _window_index.equal_range(GetWindowIndexKey(cls, number));
+	for (auto it = range.first; it != range.second; ++it) {
+		const Window *w = it->second;
+		/* The whole window is going to be marked dirty anyway. */
+		if (w->flags & WF_DIRTY) continue;
+		w->SetWidgetDirty(widget_index);
 	}
 }
 
@@ -3136,8 +3244,11 @@ void Window::InvalidateData(int data, bool gui_scope)
 {
 	this->SetDirty();
 	if (!gui_scope) {
-		/* Schedule GUI-scope invalidation for next redraw. */
-		this->scheduled_invalidation_data.push_back(data);
+		/* Schedule GUI-scope invalidation for next redraw. Only drop a repeat of the
+		 * last scheduled data; dropping an earlier one would change the order. */
+		if (this->scheduled_invalidation_data.empty() || this->scheduled_invalidation_data.back() != data) {
+			this->scheduled_invalidation_data.push_back(data);
+		}
 	}
 	this->OnInvalidateData(data, gui_scope);
 }
@@ -3194,6 +3305,14 @@ void Window::ProcessHighlightedInvalidations()
  */
 void InvalidateWindowData(WindowClass cls, WindowNumber number, int data, bool gui_scope)
 {
+	auto range = _window_index.equal_range(GetWindowIndexKey(cls, number));
+	if (range.first == range.second) return;
+	if (std::next(range.first) == range.second) {
+		range.first->second->InvalidateData(data, gui_scope);
+		return;
+	}
+
+	/* There are several such windows; invalidating one of them may close or open others. */
 	for (Window *w : Window::Iterate()) {
 		if (w->window_class == cls && w->window_number == number) {
 			w->InvalidateData(data, gui_scope);
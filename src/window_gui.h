@@ -242,6 +242,7 @@ enum WindowFlags {
 	WF_WHITE_BORDER      = 1 <<  8, ///< Window white border counter bit mask.
 	WF_HIGHLIGHTED       = 1 <<  9, ///< Window has a widget that has a highlight.
 	WF_CENTERED          = 1 << 10, ///< Window is centered and shall stay centered after ReInit.
+	WF_DIRTY             = 1 << 11, ///< Window is to be marked dirty before the next redraw, see #SetWindowDirty().
 };
 DECLARE_ENUM_AS_BIT_SET(WindowFlags)
 
@@ -284,6 +285,14 @@ protected:
 
 	std::vector<int> scheduled_invalidation_data;  ///< Data of scheduled OnInvalidateData() calls.
 
+private:
+	bool indexed;                  ///< Whether the window is in the index of windows by class and number.
+	WindowClass indexed_class;     ///< Class the window is indexed by.
+	WindowNumber indexed_number;   ///< Number the window is indexed by.
+
+	void AddToIndex();
+	void RemoveFromIndex();
+
 public:
 	Window(WindowDesc *desc);
 
@@ -350,6 +359,9 @@ public:
 	void CreateNestedTree(bool fill_nested = true);
 	void FinishInitNested(WindowNumber window_number = 0);
 
+	void SetWindowClass(WindowClass window_class);
+	void SetWindowNumber(WindowNumber window_number);
+
 	/**
 	 * Set the timeout flag of the window and initiate the timer.
 	 */